@@ -1,241 +1,781 @@
-#include "2105109_Heuristics.h"
+#include "2105109_Search.h"
+#include "2105109_ParallelSearch.h"
+#include "2105109_Bidirectional.h"
+#include "2105109_Anytime.h"
+#include "2105109_ExternalSearch.h"
+#include "2105109_PatternDatabase.h"
+#include <sys/socket.h>
+#include <sys/un.h>
 using namespace std;
-map<vector<vector<int>>, bool> visited;
-int noOfExploredStates = 0;
-int noOfExpandedStates = 0;
-typedef float (*HeuristicFunction)(vector<vector<int>> &);
-HeuristicFunction hieuristics = nullptr;
 
-class State
+// Each board of the path is k*k tiles in row-major order.
+void PrintPath(const vector<vector<int>> &path, int k)
 {
-public:
-    vector<vector<int>> Board;
-    int priority;
-    int hieuristic;
-    int moves;
-    State *parent;
-    bool visted = false;
-
-    State(vector<vector<int>> Board, int priority, int hieuristic, int moves, State *parent = nullptr)
-    {
-        this->Board = Board;
-        this->priority = priority;
-        this->hieuristic = hieuristic;
-        this->moves = moves;
-        this->parent = parent;
-    }
-    vector<vector<int>> &getBoard()
+    for (const auto &board : path)
     {
-        return Board;
+        for (int i = 0; i < k; i++)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                cout << board[i * k + j] << " ";
+            }
+            cout << endl;
+        }
+        cout << endl;
     }
-    int getPriority()
+}
+
+bool isSolvable(int k, const vector<vector<int>> &Board_Input)
+{
+    vector<int> tiles;
+    int blank_row = 0;
+    for (int i = 0; i < k; i++)
     {
-        return priority;
+        for (int j = 0; j < k; j++)
+        {
+            tiles.push_back(Board_Input[i][j]);
+            if (Board_Input[i][j] == 0)
+            {
+                blank_row = i;
+            }
+        }
     }
-    int getMoves()
+    long long inversions = Inversion_Count(tiles);
+    if (k % 2 == 1)
     {
-        return moves;
+        return inversions % 2 == 0;
     }
-    State *getParent()
+    else
     {
-        return parent;
+        bool first_Condition = (blank_row % 2 == 0) && (inversions % 2 == 1);
+        bool second_Condition = (blank_row % 2 == 1) && (inversions % 2 == 0);
+        return (first_Condition || second_Condition);
     }
-};
-pair<int, int> getBlankTilePosition(vector<vector<int>> &Board)
+}
+
+// "1,5,6/7,8" -> {{1, 5, 6}, {7, 8}}
+vector<vector<int>> parseGroups(const string &text)
 {
-    for (int i = 0; i < Board.size(); i++)
+    vector<vector<int>> groups;
+    stringstream groupStream(text);
+    string groupText, tileText;
+    while (getline(groupStream, groupText, '/'))
     {
-        for (int j = 0; j < Board[i].size(); j++)
+        vector<int> group;
+        stringstream tileStream(groupText);
+        while (getline(tileStream, tileText, ','))
         {
-            if (Board[i][j] == 0)
-            {
-                return {i, j};
-            }
+            group.push_back(stoi(tileText));
         }
+        groups.push_back(group);
     }
-    return {-1, -1};
+    return groups;
+}
+
+const vector<string> HEURISTIC_NAMES = {"Hamming", "Manhatten", "Linear", "Euclidean", "Walking", "WalkingLinear", "PDB"};
+const vector<string> ENGINE_NAMES = {"AStar", "IDAStar", "External", "ExternalBFS", "Bidirectional", "HDAStar", "WeightedAStar", "Beam"};
+
+bool isOneOf(const string &name, const vector<string> &names)
+{
+    return find(names.begin(), names.end(), name) != names.end();
 }
-struct CompareState
+
+// Points this thread's heuristic at heuristicName, loading its tables for side
+// k the first time they are needed. False for unknown names and missing tables.
+mutex tableLock;
+
+bool selectHeuristic(const string &heuristicName, int k)
 {
-    bool operator()(const State *a, const State *b)
+    if (heuristicName == "Hamming")
+    {
+        hieuristics = Hamming_Distance;
+        hieuristicsDelta = Hamming_Distance_Delta;
+    }
+    else if (heuristicName == "Manhatten")
     {
-        if (a->priority == b->priority)
+        hieuristics = Manhatten_Distance;
+        hieuristicsDelta = Manhatten_Distance_Delta;
+    }
+    else if (heuristicName == "Linear")
+    {
+        hieuristics = Linear_Conflict;
+        hieuristicsDelta = Linear_Conflict_Delta;
+    }
+    else if (heuristicName == "Euclidean")
+    {
+        hieuristics = Euclidean_Distance;
+        hieuristicsDelta = Euclidean_Distance_Delta;
+    }
+    else if (heuristicName == "Walking" || heuristicName == "WalkingLinear")
+    {
+        lock_guard<mutex> guard(tableLock);
+        if (k > WalkingDistanceTable::MAX_SIDE || (walkingDistanceTables[k].k != k && !walkingDistanceTables[k].load(k)))
         {
-            return a->hieuristic > b->hieuristic;
+            return false;
         }
-        return a->priority > b->priority;
+        hieuristics = heuristicName == "Walking" ? Walking_Distance : Walking_Linear;
+        hieuristicsDelta = heuristicName == "Walking" ? Walking_Distance_Delta : Walking_Linear_Delta;
     }
-};
-void FreeMemory(State *state)
+    else if (heuristicName == "PDB")
+    {
+        lock_guard<mutex> guard(tableLock);
+        if (k > PackedBoard::MAX_SIDE || (patternDatabases[k].k != k && (!patternDatabases[k].load(PatternDatabase::defaultPath(k)) || patternDatabases[k].k != k)))
+        {
+            return false;
+        }
+        hieuristics = Pattern_Database;
+        hieuristicsDelta = Pattern_Database_Delta;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+string heuristicError(const string &heuristicName, int k)
 {
-    if (state == nullptr)
-        return;
-    FreeMemory(state->getParent());
-    delete state;
+    if (!isOneOf(heuristicName, HEURISTIC_NAMES))
+        return "Unknown heuristic " + heuristicName;
+    if (heuristicName == "PDB")
+        return "Pattern database " + PatternDatabase::defaultPath(k) + " is missing or incomplete; run ./2105109 BuildPDB " + to_string(k);
+    return "Walking Distance tables need a board of side 2 to " + to_string(WalkingDistanceTable::MAX_SIDE);
 }
-void FreePriorityQueue(priority_queue<State *, vector<State *>, CompareState> &pq)
+
+// Command-line knobs of the engines. weight, beamWidth, seconds and maxNodes
+// only matter to the anytime engines (WeightedAStar, Beam), tempDirectory and
+// bufferMegabytes to the disk-backed ones (External, ExternalBFS).
+class SearchOptions
+{
+public:
+    int threads = 1;
+    float weight = 2;
+    int beamWidth = 1000;
+    double seconds = 10;
+    size_t maxNodes = 10000000;
+    string tempDirectory = "frontier";
+    size_t bufferMegabytes = 256;
+};
+
+class SolveResult
+{
+public:
+    string status = "solved";
+    int moves = -1;
+    long long noOfExploredStates = 0;
+    long long noOfExpandedStates = 0;
+    double seconds = 0;
+    string searchName;
+    // Best proven lower bound on the optimal length, or -1 if none is proven;
+    // equal to moves for the optimal engines.
+    int lowerBound = -1;
+    // Boards from start to goal, each k*k tiles in row-major order.
+    vector<vector<int>> path;
+    // JSON object of the search trace; empty unless built with -DSEARCH_TRACE.
+    string trace;
+};
+
+SolveResult solve(SolveContext &context, const vector<vector<int>> &Board_Input, const string &engineName, const SearchOptions &options)
 {
-    while (!pq.empty())
+    SolveResult result;
+    int k = Board_Input.size();
+    bool anytime = engineName == "WeightedAStar" || engineName == "Beam";
+    bool walking = hieuristics == Walking_Distance || hieuristics == Walking_Linear;
+    if (!isOneOf(engineName, ENGINE_NAMES) || k > (anytime ? LARGE_MAX_SIDE : PackedBoard::MAX_SIDE) || (hieuristics == Pattern_Database && (k > PackedBoard::MAX_SIDE || patternDatabases[k].k != k)) ||
+        (walking && (k > WalkingDistanceTable::MAX_SIDE || walkingDistanceTables[k].k != k)))
+    {
+        result.status = "unsupported";
+        return result;
+    }
+    if (!isSolvable(k, Board_Input))
+    {
+        result.status = "unsolvable";
+        return result;
+    }
+
+    context.reset();
+    auto searchStart = chrono::steady_clock::now();
+    if (anytime)
+    {
+        int beamWidth = engineName == "Beam" ? options.beamWidth : 0;
+        ostringstream name;
+        if (beamWidth > 0)
+            name << "anytime beam search, initial width " << beamWidth;
+        else
+            name << "anytime weighted A*, w = " << options.weight;
+        result.searchName = name.str();
+        bool found = anytime_Search(context, Board_Input, options.weight, beamWidth, options.seconds, options.maxNodes, result.path, result.lowerBound);
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart).count();
+        result.status = found ? "solved" : "timeout";
+        result.moves = found ? result.path.size() - 1 : -1;
+        result.noOfExploredStates = context.noOfExploredStates;
+        result.noOfExpandedStates = context.noOfExpandedStates;
+        context.trace.finish(context.bytes());
+        result.trace = context.trace.json();
+        return result;
+    }
+
+    PackedBoard Start_Board = PackedBoard::fromGrid(Board_Input);
+    PackedBoard Final_Board = PackedBoard::goal(k);
+    vector<PackedBoard> path;
+    bool found;
+    int threads = options.threads;
+    // hieuristicsDelta stays generic between solves, since one thread can
+    // solve boards of different sizes (batch and server workers).
+    HeuristicDelta genericDelta = hieuristicsDelta;
+    hieuristicsDelta = specializeDelta(genericDelta, k);
+    if (engineName == "IDAStar")
+    {
+        result.searchName = "IDA*";
+        found = ida_Star(context, Start_Board, Final_Board, path);
+    }
+    else if (engineName == "External" || engineName == "ExternalBFS")
+    {
+        bool useHieuristic = engineName == "External";
+        result.searchName = useHieuristic ? "external breadth-first heuristic search" : "external breadth-first search";
+        found = external_Search(context, Start_Board, Final_Board, path, options.tempDirectory, options.bufferMegabytes, useHieuristic);
+    }
+    else if (engineName == "Bidirectional")
+    {
+        result.searchName = "bidirectional MM";
+        found = mm_Search(context, Start_Board, Final_Board, path);
+    }
+    else if (engineName == "HDAStar")
+    {
+        result.searchName = "HDA*, " + to_string(min(threads, HDA_MAX_THREADS)) + " threads";
+        if (hieuristics == Euclidean_Distance)
+            found = hda_Star<HeapOpenList>(context, Start_Board, Final_Board, path, threads);
+        else
+            found = hda_Star<BucketOpenList>(context, Start_Board, Final_Board, path, threads);
+    }
+    else if (hieuristics == Euclidean_Distance)
+    {
+        result.searchName = "A*, binary heap open list";
+        found = a_Star<HeapOpenList>(context, Start_Board, Final_Board, path);
+    }
+    else
+    {
+        result.searchName = "A*, bucket open list";
+        found = a_Star<BucketOpenList>(context, Start_Board, Final_Board, path);
+    }
+    hieuristicsDelta = genericDelta;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart).count();
+    result.moves = found ? path.size() - 1 : -1;
+    result.lowerBound = result.moves;
+    if (SearchTrace::ENABLED)
+    {
+        for (int i = 0; i < (int)path.size(); i++)
+        {
+            context.trace.heuristicError(result.moves - i - hieuristics(path[i]));
+        }
+    }
+    for (const auto &board : path)
     {
-        State *state = pq.top();
-        pq.pop();
-        delete state;
+        vector<int> tiles(k * k);
+        for (int cell = 0; cell < k * k; cell++)
+        {
+            tiles[cell] = board.get(cell);
+        }
+        result.path.push_back(tiles);
     }
+    result.noOfExploredStates = context.noOfExploredStates;
+    result.noOfExpandedStates = context.noOfExpandedStates;
+    context.trace.finish(context.bytes());
+    result.trace = context.trace.json();
+    return result;
 }
 
-void Print(State *goal)
+// Batch mode: the input is a stream of puzzles, each k followed by k*k tiles.
+// Puzzles are handed out to a pool of workers, each with its own SolveContext,
+// and the results are written in input order as CSV or JSON lines.
+int runBatch(const string &engineName, const string &inputPath, const string &outputPath, const string &format, const SearchOptions &options)
 {
-    State *current = goal;
-    vector<vector<vector<int>>> path;
-    while (current != nullptr)
+    ifstream input(inputPath);
+    ofstream output(outputPath);
+    if (!input.is_open() || !output.is_open())
     {
-        path.push_back(current->getBoard());
-        current = current->getParent();
+        cerr << "Could not open " << (input.is_open() ? outputPath : inputPath) << "\n";
+        return 1;
     }
-    reverse(path.begin(), path.end());
-    for (const auto &board : path)
+
+    vector<vector<vector<int>>> puzzles;
+    int k;
+    while (input >> k)
     {
-        for (const auto &row : board)
+        vector<vector<int>> Board_Input(k, vector<int>(k));
+        for (int i = 0; i < k; i++)
         {
-            for (const auto &val : row)
+            for (int j = 0; j < k; j++)
             {
-                cout << val << " ";
+                input >> Board_Input[i][j];
             }
-            cout << endl;
         }
-        cout << endl;
+        puzzles.push_back(Board_Input);
     }
+
+    // Small batches hand the spare threads to each solve (used by HDA*).
+    int poolSize = max<int>(1, min<size_t>(options.threads, puzzles.size()));
+    SearchOptions solveOptions = options;
+    solveOptions.threads = max(1, options.threads / poolSize);
+    vector<SolveResult> results(puzzles.size());
+    atomic<size_t> next(0);
+    vector<thread> workers;
+    HeuristicFunction heuristic = hieuristics;
+    HeuristicDelta heuristicDelta = hieuristicsDelta;
+    for (int t = 0; t < poolSize; t++)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 hieuristics = heuristic;
+                                 hieuristicsDelta = heuristicDelta;
+                                 SolveContext context;
+                                 for (size_t i = next++; i < puzzles.size(); i = next++)
+                                 {
+                                     results[i] = solve(context, puzzles[i], engineName, solveOptions);
+                                     results[i].path.clear();
+                                 }
+                             });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    if (format == "csv")
+    {
+        output << "puzzle,k,status,moves,explored,expanded,seconds,bound\n";
+    }
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const SolveResult &r = results[i];
+        if (format == "csv")
+        {
+            output << i + 1 << "," << puzzles[i].size() << "," << r.status << "," << r.moves << ","
+                   << r.noOfExploredStates << "," << r.noOfExpandedStates << "," << r.seconds << "," << r.lowerBound << "\n";
+        }
+        else
+        {
+            output << "{\"puzzle\":" << i + 1 << ",\"k\":" << puzzles[i].size() << ",\"status\":\"" << r.status
+                   << "\",\"moves\":" << r.moves << ",\"explored\":" << r.noOfExploredStates
+                   << ",\"expanded\":" << r.noOfExpandedStates << ",\"seconds\":" << r.seconds
+                   << ",\"bound\":" << r.lowerBound;
+            if (!r.trace.empty())
+                output << ",\"trace\":" << r.trace;
+            output << "}\n";
+        }
+    }
+    return 0;
 }
 
-void a_Star(State *start, State *goal)
+// Server mode keeps one process, its heuristic tables and every worker's
+// SolveContext alive between requests. A request is one line,
+//   <id> <heuristic> <engine> <k> <k*k tiles> [weight=W] [beam=B] [time=S] [threads=T]
+// and is answered by one JSON line carrying the same id. Requests are solved
+// concurrently, so answers can come back in a different order.
+class ServerConnection
 {
-    priority_queue<State *, vector<State *>, CompareState> pq;
-    pq.push(start);
-    noOfExploredStates++;
-    visited[start->getBoard()] = true;
+public:
+    int fd;
+    mutex writeLock;
 
-    while (!pq.empty())
+    ServerConnection(int fd) : fd(fd) {}
+    ~ServerConnection()
     {
-        auto current = pq.top();
-        noOfExpandedStates++;
-        pq.pop();
-        State *currentState = current;
-        // PrintBoard(currentState->getBoard());
+        if (fd > STDOUT_FILENO)
+            close(fd);
+    }
 
-        if (currentState->getBoard() == goal->getBoard())
+    void send(const string &line)
+    {
+        lock_guard<mutex> guard(writeLock);
+        for (size_t written = 0; written < line.size();)
         {
-            cout << "Minimum number of moves = " << currentState->getMoves() << "\n\n";
-            Print(currentState);
-            FreeMemory(currentState);
-            FreePriorityQueue(pq);
-            delete goal;
-            return;
+            ssize_t n = write(fd, line.data() + written, line.size() - written);
+            if (n <= 0)
+                return;
+            written += n;
         }
+    }
+};
 
-        vector<vector<int>> currentBoard = currentState->getBoard();
-        int n = currentBoard.size();
-        int blank_x, blank_y;
-
-        blank_x = getBlankTilePosition(currentBoard).first;
-        blank_y = getBlankTilePosition(currentBoard).second;
-
-        vector<pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+class ServerQueue
+{
+private:
+    mutex lock;
+    condition_variable ready;
+    deque<pair<string, shared_ptr<ServerConnection>>> jobs;
+    bool closed = false;
 
-        for (auto dir : directions)
+public:
+    void push(string line, shared_ptr<ServerConnection> connection)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            jobs.emplace_back(std::move(line), std::move(connection));
+        }
+        ready.notify_one();
+    }
+    // No more requests; workers finish the queued ones and stop.
+    void close()
+    {
         {
-            int new_x = blank_x + dir.first;
-            int new_y = blank_y + dir.second;
+            lock_guard<mutex> guard(lock);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+    bool pop(pair<string, shared_ptr<ServerConnection>> &job)
+    {
+        unique_lock<mutex> guard(lock);
+        ready.wait(guard, [&]()
+                   { return closed || !jobs.empty(); });
+        if (jobs.empty())
+            return false;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        return true;
+    }
+};
 
-            if (new_x >= 0 && new_x < n && new_y >= 0 && new_y < n)
-            {
-                vector<vector<int>> newBoard = currentBoard;
-                swap(newBoard[blank_x][blank_y], newBoard[new_x][new_y]);
+// s as the body of a JSON string.
+string jsonEscape(const string &s)
+{
+    ostringstream escaped;
+    for (unsigned char c : s)
+    {
+        if (c == '"' || c == '\\')
+            escaped << '\\' << c;
+        else if (c < 0x20)
+            escaped << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec;
+        else
+            escaped << c;
+    }
+    return escaped.str();
+}
 
-                if (!visited[newBoard])
-                {
-                    int newHieuristic = hieuristics(newBoard);
+string serveRequest(SolveContext &context, const string &line, const SearchOptions &defaults)
+{
+    istringstream request(line);
+    string id, heuristicName, engineName;
+    int k = 0;
+    request >> id >> heuristicName >> engineName >> k;
+    ostringstream response;
+    response << "{\"id\":\"" << jsonEscape(id) << "\"";
+    if (!request || k < 1 || k > LARGE_MAX_SIDE || !isOneOf(heuristicName, HEURISTIC_NAMES) || !isOneOf(engineName, ENGINE_NAMES))
+    {
+        response << ",\"status\":\"bad request\"}\n";
+        return response.str();
+    }
+
+    vector<vector<int>> Board_Input(k, vector<int>(k));
+    vector<bool> seen(k * k, false);
+    bool valid = true;
+    for (int cell = 0; cell < k * k && valid; cell++)
+    {
+        int &tile = Board_Input[cell / k][cell % k];
+        valid = request >> tile && tile >= 0 && tile < k * k && !seen[tile];
+        if (valid)
+            seen[tile] = true;
+    }
+    SearchOptions options = defaults;
+    string option;
+    while (valid && request >> option)
+    {
+        size_t equals = option.find('=');
+        string key = option.substr(0, equals), value = equals == string::npos ? "" : option.substr(equals + 1);
+        try
+        {
+            if (key == "weight")
+                options.weight = stof(value);
+            else if (key == "beam")
+                options.beamWidth = max(1, stoi(value));
+            else if (key == "time")
+                options.seconds = stod(value);
+            else if (key == "threads")
+                options.threads = max(1, stoi(value));
+            else
+                valid = false;
+        }
+        catch (const exception &)
+        {
+            valid = false;
+        }
+    }
+    if (!valid)
+    {
+        response << ",\"status\":\"bad request\"}\n";
+        return response.str();
+    }
+    if (!selectHeuristic(heuristicName, k))
+    {
+        response << ",\"status\":\"unsupported\",\"error\":\"" << jsonEscape(heuristicError(heuristicName, k)) << "\"}\n";
+        return response.str();
+    }
 
-                    int newPriority = currentState->getMoves() + newHieuristic; // Update priority (can include heuristic)
-                    State *newState = new State(newBoard, newPriority, newHieuristic, currentState->getMoves() + 1, currentState);
+    SolveResult r = solve(context, Board_Input, engineName, options);
+    response << ",\"status\":\"" << r.status << "\",\"moves\":" << r.moves << ",\"bound\":" << r.lowerBound
+             << ",\"explored\":" << r.noOfExploredStates << ",\"expanded\":" << r.noOfExpandedStates
+             << ",\"seconds\":" << r.seconds << ",\"path\":[";
+    for (size_t i = 0; i < r.path.size(); i++)
+    {
+        response << (i ? ",[" : "[");
+        for (size_t cell = 0; cell < r.path[i].size(); cell++)
+        {
+            response << (cell ? "," : "") << r.path[i][cell];
+        }
+        response << "]";
+    }
+    response << "]";
+    if (!r.trace.empty())
+        response << ",\"trace\":" << r.trace;
+    response << "}\n";
+    return response.str();
+}
 
-                    pq.push(newState);
-                    noOfExploredStates++;
-                    visited[newBoard] = true;
-                }
-            }
+void readRequests(int fd, shared_ptr<ServerConnection> connection, ServerQueue &queue)
+{
+    string pending;
+    char buffer[1 << 16];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        pending.append(buffer, n);
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != string::npos)
+        {
+            if (end > start)
+                queue.push(pending.substr(start, end - start), connection);
+            start = end + 1;
         }
+        pending.erase(0, start);
     }
+    if (!pending.empty())
+        queue.push(pending, connection);
 }
 
-bool isSolvable(int k, vector<vector<int>> &Board_Input)
+// Without a socket path requests come from stdin and answers go to stdout,
+// and the server exits once stdin is closed and every request is answered.
+int runServer(const string &socketPath, int workers, const SearchOptions &defaults)
 {
-    int blank_row = getBlankTilePosition(Board_Input).first;
-    if (k % 2 == 1)
+    signal(SIGPIPE, SIG_IGN);
+    ServerQueue queue;
+    vector<thread> pool;
+    for (int t = 0; t < workers; t++)
     {
-        return Inversion_Count(Board_Input, k) % 2 == 0;
+        pool.emplace_back([&]()
+                          {
+                              SolveContext context;
+                              pair<string, shared_ptr<ServerConnection>> job;
+                              while (queue.pop(job))
+                              {
+                                  job.second->send(serveRequest(context, job.first, defaults));
+                                  job.second.reset();
+                              }
+                          });
     }
-    else
+
+    if (socketPath.empty())
     {
-        bool first_Condition = (blank_row % 2 == 0) && (Inversion_Count(Board_Input, k) % 2 == 1);
-        bool second_Condition = (blank_row % 2 == 1) && (Inversion_Count(Board_Input, k) % 2 == 0);
-        return (first_Condition || second_Condition);
+        readRequests(STDIN_FILENO, make_shared<ServerConnection>(STDOUT_FILENO), queue);
+        queue.close();
+        for (auto &worker : pool)
+        {
+            worker.join();
+        }
+        return 0;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        cerr << "Socket path too long: " << socketPath << "\n";
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (listener < 0 || bind(listener, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 64) < 0)
+    {
+        cerr << "Could not listen on " << socketPath << "\n";
+        return 1;
+    }
+    cerr << "Listening on " << socketPath << "\n";
+    while (true)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        thread([fd, &queue]()
+               { readRequests(fd, make_shared<ServerConnection>(fd), queue); })
+            .detach();
     }
 }
 
 int main(int argc, char *argv[])
 {
-    freopen("input.txt", "r", stdin);
-    freopen("output.txt", "w", stdout);
-    hieuristics = Manhatten_Distance;
-
-    int n, k;
-    cin >> k;
-    n = k * k;
-    vector<vector<int>> Board_Input(k, vector<int>(k));
-    vector<vector<int>> Final_Board(k, vector<int>(k));
-
-    for (int i = 0; i < k; i++)
+    if (argc > 2 && string(argv[1]) == "BuildPDB")
     {
-        for (int j = 0; j < k; j++)
+        int k = stoi(argv[2]);
+        vector<vector<int>> groups = argc > 3 ? parseGroups(argv[3]) : PatternDatabase::defaultGroups(k);
+        string path = argc > 4 ? argv[4] : PatternDatabase::defaultPath(k);
+        if (groups.empty() || !PatternDatabase::build(k, groups, path))
         {
-            cin >> Board_Input[i][j];
-            Final_Board[i][j] = i * k + j + 1;
+            cerr << "Could not build pattern database " << path << "\n";
+            return 1;
         }
+        cerr << "Pattern database written to " << path << "\n";
+        return 0;
     }
-    Final_Board[k - 1][k - 1] = 0;
-    // cout << "Euclidean Distance Heuristic:" << Euclidean_Distance(Board_Input) << "\n";
-    // cout << "Manhatten Distance Heuristic:" << Manhatten_Distance(Board_Input) << "\n";
-    // cout << "Hamming Distance Heuristic:" << Hamming_Distance(Board_Input) << "\n";
-    // cout << "Linear Conflict Heuristic:" << Linear_Conflict(Board_Input) << "\n";
-    // cout << "Inversion Count Heuristic:" << Inversion_Count(Board_Input, k) << "\n";
-    if (isSolvable(k, Board_Input))
+
+    if (argc > 1 && string(argv[1]) == "Serve")
     {
+        string socketPath;
+        int workers = max(1u, thread::hardware_concurrency());
+        SearchOptions defaults;
+        for (int i = 2; i + 1 < argc; i += 2)
+        {
+            string option = argv[i];
+            if (option == "--socket")
+                socketPath = argv[i + 1];
+            else if (option == "--threads")
+                workers = max(1, stoi(argv[i + 1]));
+            else if (option == "--temp-dir")
+                defaults.tempDirectory = argv[i + 1];
+        }
+        return runServer(socketPath, workers, defaults);
+    }
 
-        if (argv[1] == "Hamming")
+    string heuristicName = argc > 1 ? argv[1] : "Manhatten";
+    string engineName = argc > 2 ? argv[2] : "AStar";
+    string batchInput, batchOutput, format = "csv", tracePath;
+    SearchOptions options;
+    options.threads = max(1u, thread::hardware_concurrency());
+    for (int i = 3; i < argc; i++)
+    {
+        string option = argv[i];
+        if (option == "--batch" && i + 2 < argc)
+        {
+            batchInput = argv[++i];
+            batchOutput = argv[++i];
+        }
+        else if (option == "--format" && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (option == "--threads" && i + 1 < argc)
         {
-            hieuristics = Hamming_Distance;
+            options.threads = max(1, stoi(argv[++i]));
         }
-        else if (argv[1] == "Manhatten")
+        else if (option == "--weight" && i + 1 < argc)
         {
-            hieuristics = Manhatten_Distance;
+            options.weight = stof(argv[++i]);
         }
-        else if (argv[1] == "Linear")
+        else if (option == "--beam" && i + 1 < argc)
         {
-            hieuristics = Linear_Conflict;
+            options.beamWidth = max(1, stoi(argv[++i]));
         }
-        else if (argv[1] == "Euclidean")
+        else if (option == "--time" && i + 1 < argc)
         {
-            hieuristics = Euclidean_Distance;
+            options.seconds = stod(argv[++i]);
         }
+        else if (option == "--max-nodes" && i + 1 < argc)
+        {
+            options.maxNodes = stoull(argv[++i]);
+        }
+        else if (option == "--temp-dir" && i + 1 < argc)
+        {
+            options.tempDirectory = argv[++i];
+        }
+        else if (option == "--buffer-mb" && i + 1 < argc)
+        {
+            options.bufferMegabytes = max(1, stoi(argv[++i]));
+        }
+        else if (option == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+    }
+    if (!tracePath.empty() && !SearchTrace::ENABLED)
+    {
+        cerr << "--trace needs a build with -DSEARCH_TRACE\n";
+        tracePath.clear();
+    }
 
-        State *start = new State(Board_Input, 0, 0, 0);
-        State *goal = new State(Final_Board, 0, 0, 0);
-        a_Star(start, goal);
-        cout << "No of explored states: " << noOfExploredStates << "\n";
-        cout << "No of expanded states: " << noOfExpandedStates << "\n";
+    if (!batchInput.empty())
+    {
+        ifstream peek(batchInput);
+        int k = 0;
+        peek >> k;
+        if (!selectHeuristic(heuristicName, k))
+        {
+            cerr << heuristicError(heuristicName, k) << "\n";
+            return 1;
+        }
+        return runBatch(engineName, batchInput, batchOutput, format, options);
+    }
+
+    freopen("input.txt", "r", stdin);
+    freopen("output.txt", "w", stdout);
+
+    int k;
+    cin >> k;
+    vector<vector<int>> Board_Input(k, vector<int>(k));
+
+    for (int i = 0; i < k; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            cin >> Board_Input[i][j];
+        }
+    }
+    if (!selectHeuristic(heuristicName, k))
+    {
+        cout << heuristicError(heuristicName, k) << "\n";
+        return 0;
+    }
+    // cout << "Euclidean Distance Heuristic:" << Euclidean_Distance(Start_Board) << "\n";
+    // cout << "Manhatten Distance Heuristic:" << Manhatten_Distance(Start_Board) << "\n";
+    // cout << "Hamming Distance Heuristic:" << Hamming_Distance(Start_Board) << "\n";
+    // cout << "Linear Conflict Heuristic:" << Linear_Conflict(Start_Board) << "\n";
+    // cout << "Inversion Count Heuristic:" << Inversion_Count(tiles) << "\n";
+    SolveContext context;
+    SolveResult result = solve(context, Board_Input, engineName, options);
+    if (!tracePath.empty())
+    {
+        ofstream(tracePath) << result.trace << "\n";
+    }
+    if (result.status == "solved")
+    {
+        if (result.lowerBound == result.moves)
+            cout << "Minimum number of moves = " << result.moves << "\n\n";
+        else if (result.lowerBound < 0)
+            cout << "Number of moves = " << result.moves << " (no lower bound proven)\n\n";
+        else
+            cout << "Number of moves = " << result.moves << " (best lower bound " << result.lowerBound << ")\n\n";
+        PrintPath(result.path, k);
+        cout << "No of explored states: " << result.noOfExploredStates << "\n";
+        cout << "No of expanded states: " << result.noOfExpandedStates << "\n";
+        cout << "Expanded states per second: " << (long long)(result.noOfExpandedStates / max(result.seconds, 1e-9)) << " (" << result.searchName << ")\n";
         // Print(start);
     }
 
+    else if (result.status == "unsupported" && !isOneOf(engineName, ENGINE_NAMES))
+    {
+        cout << "Unknown engine " << engineName << "\n";
+    }
+    else if (result.status == "unsupported")
+    {
+        cout << "Boards larger than " << PackedBoard::MAX_SIDE << "x" << PackedBoard::MAX_SIDE << " need the WeightedAStar or Beam engine\n";
+    }
+    else if (result.status == "timeout" && result.lowerBound < 0)
+    {
+        cout << "No solution found within the time budget\n";
+    }
+    else if (result.status == "timeout")
+    {
+        cout << "No solution found within the time budget (lower bound " << result.lowerBound << ")\n";
+    }
     else
     {
         cout << "Unsolvable puzzle\n";
@@ -245,9 +785,28 @@ int main(int argc, char *argv[])
 }
 
 /*
-g++ -fsanitize=address -g 2105109.cpp -o 2105109
+g++ -fsanitize=address -g -DDEBUG_HEURISTICS 2105109.cpp -o 2105109
 ./2105109  Hamming
 ./2105109  Linear
 ./2105109  Manhatten
 ./2105109  Euclidean
+./2105109  Manhatten IDAStar
+./2105109  Linear IDAStar
+./2105109  BuildPDB 3
+./2105109  PDB
+./2105109  PDB IDAStar
+./2105109  Walking
+./2105109  WalkingLinear IDAStar
+./2105109  Linear HDAStar --threads 8
+./2105109  Linear Bidirectional
+./2105109  Linear External --temp-dir /tmp/frontier --buffer-mb 64
+./2105109  Linear ExternalBFS
+./2105109  Linear WeightedAStar --weight 3 --time 30
+./2105109  Linear Beam --beam 1000 --time 30
+./2105109  Linear AStar --batch puzzles.txt results.csv
+./2105109  Linear IDAStar --batch puzzles.txt results.jsonl --format jsonl --threads 4
+g++ -O2 -DSEARCH_TRACE 2105109.cpp -o 2105109 && ./2105109 Linear AStar --trace trace.json
+./2105109  Serve --socket /tmp/npuzzle.sock --threads 4
+echo "1 Linear AStar 3 1 2 3 4 5 6 0 7 8" | ./2105109 Serve
+python3 benchmark.py --output benchmark.csv --baseline previous.csv
 */
\ No newline at end of file
@@ -0,0 +1,413 @@
+#pragma once
+#include "2105109_Search.h"
+
+// Bounded-suboptimal search for boards of any side, including those too large
+// for PackedBoard. Boards are stored one byte per cell, so k is capped at 15.
+const int LARGE_MAX_SIDE = TargetHeuristic::MAX_SIDE;
+
+// Nodes with their boards in one byte pool, plus an open-addressing table from
+// board to the node holding its cheapest known path.
+class LargeNodePool
+{
+public:
+    struct Node
+    {
+        uint64_t hash;
+        int moves;
+        float hieuristic;
+        // Manhattan distance, the admissible estimate behind lowerBound.
+        float bound;
+        uint32_t parent;
+        int16_t blank;
+    };
+
+private:
+    int cells;
+    vector<uint8_t> tiles;
+    vector<Node> nodes;
+    vector<uint32_t> slots;
+
+    // Rehashes the table entries only: superseded nodes of a board must not
+    // come back and shadow its cheapest one.
+    void grow()
+    {
+        vector<uint32_t> old;
+        old.swap(slots);
+        slots.assign(max<size_t>(1024, old.size() * 2), 0);
+        size_t mask = slots.size() - 1;
+        for (uint32_t slot : old)
+        {
+            if (slot == 0)
+                continue;
+            size_t i = nodes[slot - 1].hash & mask;
+            while (slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+
+public:
+    static const uint32_t NONE = UINT32_MAX;
+
+    LargeNodePool(int cells) : cells(cells) {}
+
+    static uint64_t hash(const uint8_t *board, int cells)
+    {
+        uint64_t h = cells;
+        for (int i = 0; i < cells; i += 8)
+        {
+            uint64_t chunk = 0;
+            memcpy(&chunk, board + i, min(8, cells - i));
+            h = hashBoard(chunk, h);
+        }
+        return h;
+    }
+
+    const uint8_t *board(uint32_t index) const
+    {
+        return tiles.data() + (size_t)index * cells;
+    }
+    const Node &operator[](uint32_t index) const
+    {
+        return nodes[index];
+    }
+    uint32_t size() const
+    {
+        return nodes.size();
+    }
+
+    // Index of the node stored for this board, or NONE.
+    uint32_t find(const uint8_t *board, uint64_t h) const
+    {
+        if (slots.empty())
+            return NONE;
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask; slots[i] != 0; i = (i + 1) & mask)
+        {
+            const Node &node = nodes[slots[i] - 1];
+            if (node.hash == h && memcmp(this->board(slots[i] - 1), board, cells) == 0)
+                return slots[i] - 1;
+        }
+        return NONE;
+    }
+
+    // Adds a node and makes it the table entry for its board.
+    uint32_t add(const uint8_t *board, uint64_t h, int moves, float hieuristic, float bound, uint32_t parent, int blank)
+    {
+        if (2 * (nodes.size() + 1) > slots.size())
+            grow();
+        uint32_t index = nodes.size();
+        tiles.insert(tiles.end(), board, board + cells);
+        nodes.push_back({h, moves, hieuristic, bound, parent, (int16_t)blank});
+
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        for (; slots[i] != 0; i = (i + 1) & mask)
+        {
+            const Node &node = nodes[slots[i] - 1];
+            if (node.hash == h && memcmp(this->board(slots[i] - 1), board, cells) == 0)
+                break;
+        }
+        slots[i] = index + 1;
+        return index;
+    }
+
+    void clear()
+    {
+        tiles.clear();
+        nodes.clear();
+        slots.clear();
+    }
+};
+
+// Anytime search: both modes keep the best solution found so far (the
+// incumbent), prune anything that cannot beat it, and go on improving it until
+// the time budget or the node budget runs out. The chosen heuristic h only
+// orders the search; pruning and lowerBound use the Manhattan distance, since
+// h may be inadmissible (Linear Conflict).
+//
+//   weighted A*: expands by g + w*h and keeps expanding after the first
+//                solution; if the open list empties, the incumbent is optimal.
+//   beam:        layer-by-layer search keeping the `width` children with the
+//                smallest h; restarted with twice the width after each pass.
+//
+// lowerBound is the best proven lower bound on the optimal length, or -1.
+class AnytimeSearch
+{
+private:
+    struct OpenEntry
+    {
+        float priority;
+        float hieuristic;
+        uint32_t node;
+
+        bool operator<(const OpenEntry &other) const
+        {
+            if (priority != other.priority)
+                return priority > other.priority;
+            return hieuristic > other.hieuristic;
+        }
+    };
+
+    struct Candidate
+    {
+        float hieuristic;
+        float bound;
+        uint32_t parent;
+        int cell;
+    };
+
+    int n;
+    int cells;
+    TargetHeuristic hieuristic;
+    TargetHeuristic admissible;
+    LargeNodePool pool;
+    vector<uint8_t> goal;
+    chrono::steady_clock::time_point deadline;
+    size_t maxNodes;
+    SolveContext &context;
+
+    bool outOfBudget()
+    {
+        return pool.size() >= maxNodes || chrono::steady_clock::now() >= deadline;
+    }
+
+    static int ceilCost(float f)
+    {
+        return (int)ceil(f - 1e-3f);
+    }
+
+    void recordSolution(uint32_t node)
+    {
+        incumbent = pool[node].moves;
+        path.clear();
+        for (uint32_t current = node; current != LargeNodePool::NONE; current = pool[current].parent)
+        {
+            path.emplace_back(pool.board(current), pool.board(current) + cells);
+        }
+        reverse(path.begin(), path.end());
+    }
+
+    // Builds the child of `parent` reached by sliding the tile at `cell` into
+    // the blank, and returns its heuristic value; bound receives its Manhattan
+    // distance.
+    float makeChild(uint32_t parent, int cell, uint8_t *child, float &bound)
+    {
+        const LargeNodePool::Node &node = pool[parent];
+        memcpy(child, pool.board(parent), cells);
+        int tile = child[cell];
+        child[node.blank] = tile;
+        child[cell] = 0;
+        context.noOfExploredStates++;
+        bound = admissible.delta(child, node.bound, tile, cell, node.blank);
+        return hieuristic.delta(child, node.hieuristic, tile, cell, node.blank);
+    }
+
+    template <class Visit>
+    void forEachMove(int blank, Visit visit)
+    {
+        int x = blank / n, y = blank % n;
+        if (x > 0)
+            visit(blank - n);
+        if (x < n - 1)
+            visit(blank + n);
+        if (y > 0)
+            visit(blank - 1);
+        if (y < n - 1)
+            visit(blank + 1);
+    }
+
+public:
+    int incumbent = INT_MAX;
+    int lowerBound = -1;
+    vector<vector<uint8_t>> path;
+
+    AnytimeSearch(SolveContext &context, int n, TargetHeuristic::Kind kind, double seconds, size_t maxNodes)
+        : n(n), cells(n * n), hieuristic(n, kind), admissible(n, TargetHeuristic::MANHATTEN), pool(n * n), goal(n * n), maxNodes(maxNodes), context(context)
+    {
+        for (int cell = 0; cell + 1 < cells; cell++)
+            goal[cell] = cell + 1;
+        deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+    }
+
+    void weightedAStar(const vector<uint8_t> &start, float weight)
+    {
+        pool.clear();
+        priority_queue<OpenEntry> open;
+        // Open entries by ceil(g + h), for the lower bound when time runs out.
+        vector<long long> costCount;
+        auto push = [&](uint32_t node)
+        {
+            const LargeNodePool::Node &state = pool[node];
+            open.push({state.moves + weight * state.hieuristic, state.hieuristic, node});
+            int f = ceilCost(state.moves + state.bound);
+            if (f >= (int)costCount.size())
+                costCount.resize(f + 1, 0);
+            costCount[f]++;
+        };
+
+        int blank = find(start.begin(), start.end(), 0) - start.begin();
+        float startHieuristic = hieuristic(start.data());
+        float startBound = admissible(start.data());
+        lowerBound = ceilCost(startBound);
+        push(pool.add(start.data(), LargeNodePool::hash(start.data(), cells), 0, startHieuristic, startBound, LargeNodePool::NONE, blank));
+        context.noOfExploredStates++;
+
+        vector<uint8_t> child(cells);
+        bool exhausted = true;
+        for (long long step = 0; !open.empty(); step++)
+        {
+            if ((step & 255) == 0 && outOfBudget())
+            {
+                exhausted = false;
+                break;
+            }
+            OpenEntry top = open.top();
+            open.pop();
+            const LargeNodePool::Node current = pool[top.node];
+            costCount[ceilCost(current.moves + current.bound)]--;
+            if (pool.find(pool.board(top.node), current.hash) != top.node)
+                continue;
+            if (current.moves + current.bound >= incumbent)
+                continue;
+            if (memcmp(pool.board(top.node), goal.data(), cells) == 0)
+            {
+                recordSolution(top.node);
+                continue;
+            }
+            context.noOfExpandedStates++;
+
+            forEachMove(current.blank, [&](int cell)
+                        {
+                            float bound;
+                            float h = makeChild(top.node, cell, child.data(), bound);
+                            int moves = current.moves + 1;
+                            if (moves + bound >= incumbent)
+                                return;
+                            uint64_t hash = LargeNodePool::hash(child.data(), cells);
+                            uint32_t seen = pool.find(child.data(), hash);
+                            if (seen != LargeNodePool::NONE && pool[seen].moves <= moves)
+                                return;
+                            push(pool.add(child.data(), hash, moves, h, bound, top.node, cell));
+                        });
+        }
+
+        if (exhausted && incumbent != INT_MAX)
+        {
+            lowerBound = incumbent;
+            return;
+        }
+        int f = 0;
+        while (f < (int)costCount.size() && costCount[f] == 0)
+            f++;
+        lowerBound = max(lowerBound, min(f, incumbent));
+    }
+
+    void beamSearch(const vector<uint8_t> &start, int width)
+    {
+        float startHieuristic = hieuristic(start.data());
+        float startBound = admissible(start.data());
+        lowerBound = ceilCost(startBound);
+        int blank = find(start.begin(), start.end(), 0) - start.begin();
+        vector<uint8_t> child(cells);
+
+        for (; !outOfBudget(); width *= 2)
+        {
+            pool.clear();
+            vector<uint32_t> layer = {pool.add(start.data(), LargeNodePool::hash(start.data(), cells), 0, startHieuristic, startBound, LargeNodePool::NONE, blank)};
+            context.noOfExploredStates++;
+            bool truncated = false;
+            while (!layer.empty() && !outOfBudget())
+            {
+                vector<Candidate> candidates;
+                for (uint32_t node : layer)
+                {
+                    const LargeNodePool::Node current = pool[node];
+                    if (memcmp(pool.board(node), goal.data(), cells) == 0)
+                    {
+                        if (current.moves < incumbent)
+                            recordSolution(node);
+                        continue;
+                    }
+                    context.noOfExpandedStates++;
+                    forEachMove(current.blank, [&](int cell)
+                                {
+                                    float bound;
+                                    float h = makeChild(node, cell, child.data(), bound);
+                                    if (current.moves + 1 + bound < incumbent)
+                                        candidates.push_back({h, bound, node, cell});
+                                });
+                }
+                if ((int)candidates.size() > width)
+                {
+                    nth_element(candidates.begin(), candidates.begin() + width, candidates.end(),
+                                [](const Candidate &a, const Candidate &b)
+                                { return a.hieuristic < b.hieuristic; });
+                    candidates.resize(width);
+                    truncated = true;
+                }
+
+                layer.clear();
+                for (const Candidate &candidate : candidates)
+                {
+                    const LargeNodePool::Node &parent = pool[candidate.parent];
+                    int moves = parent.moves + 1;
+                    int parentBlank = parent.blank;
+                    memcpy(child.data(), pool.board(candidate.parent), cells);
+                    child[parentBlank] = child[candidate.cell];
+                    child[candidate.cell] = 0;
+                    uint64_t hash = LargeNodePool::hash(child.data(), cells);
+                    uint32_t seen = pool.find(child.data(), hash);
+                    if (seen != LargeNodePool::NONE && pool[seen].moves <= moves)
+                        continue;
+                    layer.push_back(pool.add(child.data(), hash, moves, candidate.hieuristic, candidate.bound, candidate.parent, candidate.cell));
+                }
+            }
+            // A pass that never dropped a child was a complete breadth-first
+            // search, pruned only by the admissible bound, so its incumbent is
+            // optimal.
+            if (!truncated && layer.empty())
+            {
+                lowerBound = incumbent;
+                break;
+            }
+        }
+    }
+};
+
+// Fills `path` with the flattened boards from start to goal. Returns whether a
+// solution was found; `lowerBound` receives the best proven bound, or -1.
+bool anytime_Search(SolveContext &context, const vector<vector<int>> &Board_Input, float weight, int beamWidth,
+                    double seconds, size_t maxNodes, vector<vector<int>> &path, int &lowerBound)
+{
+    int n = Board_Input.size();
+    vector<uint8_t> start;
+    for (const auto &row : Board_Input)
+    {
+        start.insert(start.end(), row.begin(), row.end());
+    }
+
+    // Walking Distance and PDB tables only exist up to 5x5; Manhattan
+    // distance stands in for them.
+    TargetHeuristic::Kind kind = TargetHeuristic::MANHATTEN;
+    if (hieuristics == Hamming_Distance)
+        kind = TargetHeuristic::HAMMING;
+    else if (hieuristics == Euclidean_Distance)
+        kind = TargetHeuristic::EUCLIDEAN;
+    else if (hieuristics == Linear_Conflict || hieuristics == Walking_Linear)
+        kind = TargetHeuristic::LINEAR;
+
+    AnytimeSearch search(context, n, kind, seconds, maxNodes);
+    if (beamWidth > 0)
+        search.beamSearch(start, beamWidth);
+    else
+        search.weightedAStar(start, weight);
+
+    lowerBound = search.lowerBound;
+    path.clear();
+    for (const auto &board : search.path)
+    {
+        path.emplace_back(board.begin(), board.end());
+    }
+    return !path.empty();
+}
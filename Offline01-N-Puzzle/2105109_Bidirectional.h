@@ -0,0 +1,145 @@
+#pragma once
+#include "2105109_Search.h"
+
+// Bidirectional search with the MM priority pr(n) = max(g + h, 2g), which
+// guarantees that the two frontiers meet in the middle. Every generated node is
+// looked up in the other direction's table to improve the best known solution
+// U, and the search stops once U <= min(prmin forward, prmin backward), which
+// is a lower bound on the optimal cost when both heuristics are admissible.
+class BidirectionalSearch
+{
+private:
+    struct OpenEntry
+    {
+        float priority;
+        int moves;
+        uint32_t node;
+
+        bool operator<(const OpenEntry &other) const
+        {
+            if (priority != other.priority)
+                return priority > other.priority;
+            return moves > other.moves;
+        }
+    };
+
+    struct Frontier
+    {
+        NodeArena arena;
+        PackedBoardMap best;
+        priority_queue<OpenEntry> open;
+    };
+
+    Frontier frontier[2];
+    float bestCost = numeric_limits<float>::infinity();
+    uint32_t meeting[2] = {NodeArena::NONE, NodeArena::NONE};
+
+    // Drops queue entries whose node has been superseded by a cheaper copy.
+    float minimumPriority(Frontier &side)
+    {
+        while (!side.open.empty())
+        {
+            const OpenEntry &top = side.open.top();
+            if (*side.best.find(side.arena[top.node].getBoard()) == top.node)
+                return top.priority;
+            side.open.pop();
+        }
+        return numeric_limits<float>::infinity();
+    }
+
+    void add(SolveContext &context, int direction, const PackedBoard &board, float hieuristic, int moves, uint32_t parent)
+    {
+        Frontier &side = frontier[direction];
+        bool inserted;
+        uint32_t &best = side.best.emplace(board, 0, inserted);
+        if (!inserted && side.arena[best].getMoves() <= moves)
+            return;
+        uint32_t node = side.arena.add(board, 0, hieuristic, moves, parent);
+        best = node;
+        side.open.push({max(moves + hieuristic, 2.0f * moves), moves, node});
+        context.noOfExploredStates++;
+
+        const uint32_t *other = frontier[1 - direction].best.find(board);
+        if (other != nullptr)
+        {
+            float cost = moves + frontier[1 - direction].arena[*other].getMoves();
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                meeting[direction] = node;
+                meeting[1 - direction] = *other;
+            }
+        }
+    }
+
+public:
+    bool run(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+    {
+        // Manhattan distance stands in for heuristics that only exist towards
+        // the standard goal (Walking Distance, the pattern databases); the
+        // stopping test needs an admissible one.
+        TargetHeuristic::Kind kind = TargetHeuristic::MANHATTEN;
+        if (hieuristics == Hamming_Distance)
+            kind = TargetHeuristic::HAMMING;
+        else if (hieuristics == Euclidean_Distance)
+            kind = TargetHeuristic::EUCLIDEAN;
+        else if (hieuristics == Linear_Conflict)
+            kind = TargetHeuristic::LINEAR;
+        TargetHeuristic towardsStart(start, kind);
+
+        add(context, 0, start, hieuristics(start), 0, NodeArena::NONE);
+        add(context, 1, goal, towardsStart(goal), 0, NodeArena::NONE);
+
+        while (true)
+        {
+            float forward = minimumPriority(frontier[0]);
+            float backward = minimumPriority(frontier[1]);
+            if (bestCost <= min(forward, backward) || (forward == numeric_limits<float>::infinity() && backward == numeric_limits<float>::infinity()))
+                break;
+
+            int direction = forward <= backward ? 0 : 1;
+            Frontier &side = frontier[direction];
+            uint32_t current = side.open.top().node;
+            side.open.pop();
+            State currentState = side.arena[current];
+            const PackedBoard &currentBoard = currentState.getBoard();
+            context.noOfExpandedStates++;
+            context.trace.expand(currentState.getMoves() + currentState.hieuristic, frontier[0].open.size() + frontier[1].open.size(), 0);
+
+            int n = currentBoard.k;
+            auto [blank_x, blank_y] = getBlankTilePosition(currentBoard);
+            static const int directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+            for (auto dir : directions)
+            {
+                int new_x = blank_x + dir[0];
+                int new_y = blank_y + dir[1];
+                if (new_x < 0 || new_x >= n || new_y < 0 || new_y >= n)
+                    continue;
+                int cell = new_x * n + new_y;
+                PackedBoard newBoard = currentBoard;
+                newBoard.moveBlank(cell);
+                int tile = currentBoard.get(cell);
+                float newHieuristic = direction == 0
+                                          ? childHieuristic(newBoard, currentState.hieuristic, tile, cell, currentBoard.blank)
+                                          : towardsStart.delta(newBoard, currentState.hieuristic, tile, cell, currentBoard.blank);
+                add(context, direction, newBoard, newHieuristic, currentState.getMoves() + 1, current);
+            }
+        }
+
+        path.clear();
+        if (meeting[0] == NodeArena::NONE)
+            return false;
+        path = tracePath(frontier[0].arena, meeting[0]);
+        for (uint32_t node = frontier[1].arena[meeting[1]].getParent(); node != NodeArena::NONE; node = frontier[1].arena[node].getParent())
+        {
+            path.push_back(frontier[1].arena[node].getBoard());
+        }
+        return true;
+    }
+};
+
+bool mm_Search(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+{
+    BidirectionalSearch search;
+    return search.run(context, start, goal, path);
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+// A board of side k <= 5 packed into two 64-bit words. Cell c stores the low
+// four bits of its tile as nibble c of lo (cells 0..15) or of hi (cells 16..24).
+// The fifth bit of every tile is kept in hi bits 36..60, so for k <= 4 the whole
+// board lives in lo and hi stays zero.
+class PackedBoard
+{
+public:
+    static const int MAX_SIDE = 5;
+
+    static constexpr uint16_t NO_CONFIGURATION = 0xFFFF;
+
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    int8_t k = 0;
+    int8_t blank = 0;
+    // Walking Distance configuration numbers of the rows and columns as they
+    // were configurationAge moves ago (2: unknown). They fit in the padding,
+    // are not part of equality or hashing, and ride along when a child is
+    // copied from its parent, so Walking_Distance_Delta can step them.
+    mutable uint8_t configurationAge = 2;
+    mutable uint16_t rowConfiguration = NO_CONFIGURATION;
+    mutable uint16_t columnConfiguration = NO_CONFIGURATION;
+
+    int get(int cell) const
+    {
+        int tile = cell < 16 ? (lo >> (4 * cell)) & 15 : (hi >> (4 * (cell - 16))) & 15;
+        return tile | (int)((hi >> (36 + cell)) & 1) << 4;
+    }
+    int get(int row, int col) const
+    {
+        return get(row * k + col);
+    }
+    void set(int cell, int tile)
+    {
+        uint64_t nibble = tile & 15;
+        if (cell < 16)
+        {
+            lo = (lo & ~(15ULL << (4 * cell))) | (nibble << (4 * cell));
+        }
+        else
+        {
+            int shift = 4 * (cell - 16);
+            hi = (hi & ~(15ULL << shift)) | (nibble << shift);
+        }
+        hi = (hi & ~(1ULL << (36 + cell))) | ((uint64_t)(tile >> 4) << (36 + cell));
+        configurationAge = 2;
+        if (tile == 0)
+        {
+            blank = cell;
+        }
+    }
+    // Slides the tile at cell into the blank.
+    void moveBlank(int cell)
+    {
+        int age = configurationAge;
+        int from = blank;
+        set(from, get(cell));
+        set(cell, 0);
+        configurationAge = min(age + 1, 2);
+    }
+    bool operator==(const PackedBoard &other) const
+    {
+        return lo == other.lo && hi == other.hi;
+    }
+    bool operator!=(const PackedBoard &other) const
+    {
+        return !(*this == other);
+    }
+
+    static PackedBoard fromGrid(const vector<vector<int>> &Board)
+    {
+        PackedBoard board;
+        board.k = Board.size();
+        for (int i = 0; i < board.k; i++)
+        {
+            for (int j = 0; j < board.k; j++)
+            {
+                board.set(i * board.k + j, Board[i][j]);
+            }
+        }
+        return board;
+    }
+    static PackedBoard goal(int k)
+    {
+        PackedBoard board;
+        board.k = k;
+        for (int cell = 0; cell < k * k - 1; cell++)
+        {
+            board.set(cell, cell + 1);
+        }
+        board.set(k * k - 1, 0);
+        return board;
+    }
+};
+
+inline uint64_t hashBoard(uint64_t lo, uint64_t hi)
+{
+    uint64_t x = lo ^ (hi * 0x9E3779B97F4A7C15ULL);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Board -> 32-bit value table (best g, node index): open addressing with
+// linear probing over the packed words. The all-zero key marks an empty slot;
+// only a 1x1 board packs to it, so that one key is tracked by a flag instead.
+class PackedBoardMap
+{
+private:
+    struct Slot
+    {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        uint32_t value = 0;
+    };
+    vector<Slot> slots;
+    size_t count = 0;
+    bool hasZero = false;
+    uint32_t zeroValue = 0;
+
+    void grow()
+    {
+        vector<Slot> old;
+        old.swap(slots);
+        slots.assign(max<size_t>(1024, old.size() * 2), Slot());
+        size_t mask = slots.size() - 1;
+        for (const auto &slot : old)
+        {
+            if (slot.lo == 0 && slot.hi == 0)
+                continue;
+            size_t i = hashBoard(slot.lo, slot.hi) & mask;
+            while (slots[i].lo != 0 || slots[i].hi != 0)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+
+public:
+    // Returns the value stored for board, inserting `value` first when the
+    // board is new; `inserted` reports which of the two happened.
+    uint32_t &emplace(const PackedBoard &board, uint32_t value, bool &inserted)
+    {
+        if (board.lo == 0 && board.hi == 0)
+        {
+            inserted = !hasZero;
+            if (inserted)
+                zeroValue = value;
+            hasZero = true;
+            return zeroValue;
+        }
+        if (2 * (count + 1) > slots.size())
+            grow();
+        size_t mask = slots.size() - 1;
+        size_t i = hashBoard(board.lo, board.hi) & mask;
+        while (slots[i].lo != 0 || slots[i].hi != 0)
+        {
+            if (slots[i].lo == board.lo && slots[i].hi == board.hi)
+            {
+                inserted = false;
+                return slots[i].value;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i].lo = board.lo;
+        slots[i].hi = board.hi;
+        slots[i].value = value;
+        count++;
+        inserted = true;
+        return slots[i].value;
+    }
+    const uint32_t *find(const PackedBoard &board) const
+    {
+        if (board.lo == 0 && board.hi == 0)
+            return hasZero ? &zeroValue : nullptr;
+        if (slots.empty())
+            return nullptr;
+        size_t mask = slots.size() - 1;
+        size_t i = hashBoard(board.lo, board.hi) & mask;
+        while (slots[i].lo != 0 || slots[i].hi != 0)
+        {
+            if (slots[i].lo == board.lo && slots[i].hi == board.hi)
+                return &slots[i].value;
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+    size_t size() const
+    {
+        return count + hasZero;
+    }
+    size_t bytes() const
+    {
+        return slots.capacity() * sizeof(slots[0]);
+    }
+    void clear()
+    {
+        slots.clear();
+        count = 0;
+        hasZero = false;
+    }
+};
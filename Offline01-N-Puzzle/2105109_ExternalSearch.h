@@ -0,0 +1,337 @@
+#pragma once
+#include "2105109_Search.h"
+#include <unistd.h>
+
+// External-memory breadth-first heuristic search with delayed duplicate
+// detection. Layer d (all boards first reached after d moves) lives in a
+// sorted file. Children of layer d are collected in a bounded memory buffer,
+// sorted and written out as runs; the runs are then merged and, in the same
+// pass, anything present in layers d or d - 1 is dropped, which is every
+// duplicate a unit-cost undirected graph can produce. All file access is
+// sequential.
+//
+// Nodes with g + h above the bound are pruned; if a pass ends without reaching
+// the goal, it is repeated with the smallest pruned f as the new bound, so the
+// first solution found is optimal. Without a heuristic the first pass is a
+// plain breadth-first search.
+//
+// On disk a record is the two packed words and h, 20 bytes instead of the 32
+// of the padded struct; k is the search's and the blank is found on reading.
+struct FrontierRecord
+{
+    static const size_t FILE_BYTES = 2 * sizeof(uint64_t) + sizeof(float);
+
+    PackedBoard board;
+    float hieuristic;
+
+    bool operator<(const FrontierRecord &other) const
+    {
+        if (board.lo != other.board.lo)
+            return board.lo < other.board.lo;
+        return board.hi < other.board.hi;
+    }
+};
+
+class FrontierWriter
+{
+private:
+    FILE *file;
+    vector<char> buffer;
+
+public:
+    size_t count = 0;
+
+    FrontierWriter(const string &path) : buffer(1 << 20)
+    {
+        file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            cerr << "External search: cannot write " << path << "\n";
+            exit(1);
+        }
+        setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    }
+    ~FrontierWriter()
+    {
+        fclose(file);
+    }
+    void write(const FrontierRecord &record)
+    {
+        char bytes[FrontierRecord::FILE_BYTES];
+        memcpy(bytes, &record.board.lo, sizeof(uint64_t));
+        memcpy(bytes + sizeof(uint64_t), &record.board.hi, sizeof(uint64_t));
+        memcpy(bytes + 2 * sizeof(uint64_t), &record.hieuristic, sizeof(float));
+        fwrite(bytes, sizeof(bytes), 1, file);
+        count++;
+    }
+};
+
+class FrontierReader
+{
+private:
+    FILE *file;
+    vector<char> buffer;
+    int k;
+    FrontierRecord current;
+    bool valid = false;
+
+public:
+    FrontierReader(const string &path, int k) : buffer(1 << 20), k(k)
+    {
+        file = fopen(path.c_str(), "rb");
+        if (file != nullptr)
+        {
+            setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+            next();
+        }
+    }
+    ~FrontierReader()
+    {
+        if (file != nullptr)
+            fclose(file);
+    }
+    FrontierReader(const FrontierReader &) = delete;
+
+    // Moves to the next record; false at the end of the file.
+    bool next()
+    {
+        char bytes[FrontierRecord::FILE_BYTES];
+        valid = file != nullptr && fread(bytes, sizeof(bytes), 1, file) == 1;
+        if (!valid)
+            return false;
+        current.board = PackedBoard();
+        current.board.k = k;
+        memcpy(&current.board.lo, bytes, sizeof(uint64_t));
+        memcpy(&current.board.hi, bytes + sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&current.hieuristic, bytes + 2 * sizeof(uint64_t), sizeof(float));
+        for (int cell = 0; cell < k * k; cell++)
+        {
+            if (current.board.get(cell) == 0)
+                current.board.blank = cell;
+        }
+        return true;
+    }
+    bool done() const
+    {
+        return !valid;
+    }
+    const FrontierRecord &record() const
+    {
+        return current;
+    }
+};
+
+class ExternalSearch
+{
+private:
+    SolveContext &context;
+    string directory;
+    size_t bufferRecords;
+    PackedBoard goal;
+    bool useHieuristic;
+
+    string layerPath(int d) const
+    {
+        return directory + "/layer_" + to_string(d) + ".bin";
+    }
+    string runPath(int i) const
+    {
+        return directory + "/run_" + to_string(i) + ".bin";
+    }
+
+    void writeRun(vector<FrontierRecord> &buffer, int &runs)
+    {
+        sort(buffer.begin(), buffer.end());
+        FrontierWriter run(runPath(runs++));
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            if (i == 0 || buffer[i - 1] < buffer[i])
+                run.write(buffer[i]);
+        }
+        buffer.clear();
+    }
+
+    // Expands layer d into sorted runs. Returns true if the goal is in layer d.
+    bool expandLayer(int d, float bound, float &nextBound, int &runs)
+    {
+        vector<FrontierRecord> buffer;
+        buffer.reserve(bufferRecords);
+        for (FrontierReader layer(layerPath(d), goal.k); !layer.done(); layer.next())
+        {
+            const FrontierRecord &current = layer.record();
+            if (current.board == goal)
+                return true;
+            context.noOfExpandedStates++;
+            context.trace.expand(d + current.hieuristic, buffer.size(), 0);
+
+            const PackedBoard &currentBoard = current.board;
+            forEachNeighbour<0>(currentBoard, [&](int cell)
+                                {
+                                    FrontierRecord child;
+                                    child.board = currentBoard;
+                                    child.board.moveBlank(cell);
+                                    child.hieuristic = useHieuristic ? childHieuristic(child.board, current.hieuristic, currentBoard.get(cell), cell, currentBoard.blank) : 0;
+                                    context.noOfExploredStates++;
+                                    float f = d + 1 + child.hieuristic;
+                                    if (f > bound)
+                                    {
+                                        nextBound = min(nextBound, f);
+                                        return;
+                                    }
+                                    buffer.push_back(child);
+                                    if (buffer.size() == bufferRecords)
+                                        writeRun(buffer, runs);
+                                });
+        }
+        if (!buffer.empty())
+            writeRun(buffer, runs);
+        return false;
+    }
+
+    // k-way merge of the runs into layer d + 1, dropping repeats and boards
+    // already in layers d and d - 1. Returns the size of the new layer.
+    size_t mergeLayer(int d, int runs)
+    {
+        vector<unique_ptr<FrontierReader>> readers;
+        typedef pair<FrontierRecord, int> Head;
+        auto later = [](const Head &a, const Head &b)
+        { return b.first < a.first; };
+        priority_queue<Head, vector<Head>, decltype(later)> heads(later);
+        for (int i = 0; i < runs; i++)
+        {
+            readers.emplace_back(new FrontierReader(runPath(i), goal.k));
+            if (!readers[i]->done())
+                heads.push({readers[i]->record(), i});
+        }
+
+        FrontierReader current(layerPath(d), goal.k);
+        FrontierReader previous(d > 0 ? layerPath(d - 1) : "", goal.k);
+        auto seenIn = [](FrontierReader &layer, const FrontierRecord &record)
+        {
+            while (!layer.done() && layer.record() < record)
+                layer.next();
+            return !layer.done() && !(record < layer.record());
+        };
+
+        FrontierWriter next(layerPath(d + 1));
+        bool hasLast = false;
+        FrontierRecord last;
+        while (!heads.empty())
+        {
+            auto [record, i] = heads.top();
+            heads.pop();
+            if (readers[i]->next())
+                heads.push({readers[i]->record(), i});
+            if (hasLast && !(last < record))
+                continue;
+            last = record;
+            hasLast = true;
+            if (seenIn(current, record) || seenIn(previous, record))
+                continue;
+            next.write(record);
+        }
+        readers.clear();
+        for (int i = 0; i < runs; i++)
+        {
+            remove(runPath(i).c_str());
+        }
+        return next.count;
+    }
+
+    static bool adjacent(const PackedBoard &a, const PackedBoard &b)
+    {
+        bool found = false;
+        forEachNeighbour<0>(a, [&](int cell)
+                            {
+                                PackedBoard moved = a;
+                                moved.moveBlank(cell);
+                                found = found || moved == b;
+                            });
+        return found;
+    }
+
+    // Walks back from the goal in layer `depth`, scanning each earlier layer
+    // for a neighbour of the board found so far.
+    vector<PackedBoard> tracePath(int depth) const
+    {
+        vector<PackedBoard> path = {goal};
+        for (int d = depth - 1; d >= 0; d--)
+        {
+            FrontierReader layer(layerPath(d), goal.k);
+            while (!adjacent(layer.record().board, path.back()))
+                layer.next();
+            path.push_back(layer.record().board);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    void clearLayers(int last)
+    {
+        for (int d = 0; d <= last; d++)
+        {
+            remove(layerPath(d).c_str());
+        }
+    }
+
+public:
+    // Every search works in its own subdirectory, so batch workers and
+    // concurrent processes can share one temporary directory.
+    ExternalSearch(SolveContext &context, const string &directory, size_t bufferMegabytes, bool useHieuristic)
+        : context(context), useHieuristic(useHieuristic)
+    {
+        static atomic<int> searches{0};
+        this->directory = directory + "/search_" + to_string(getpid()) + "_" + to_string(searches++);
+        bufferRecords = max<size_t>(1024, bufferMegabytes * 1024 * 1024 / sizeof(FrontierRecord));
+    }
+
+    bool run(const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+    {
+        this->goal = goal;
+        filesystem::create_directories(directory);
+        FrontierRecord first{start, useHieuristic ? hieuristics(start) : 0};
+        float bound = useHieuristic ? first.hieuristic : numeric_limits<float>::infinity();
+
+        while (true)
+        {
+            {
+                FrontierWriter layer(layerPath(0));
+                layer.write(first);
+            }
+            context.noOfExploredStates++;
+            float nextBound = numeric_limits<float>::infinity();
+            int d = 0;
+            for (;; d++)
+            {
+                int runs = 0;
+                if (expandLayer(d, bound, nextBound, runs))
+                {
+                    path = tracePath(d);
+                    filesystem::remove_all(directory);
+                    return true;
+                }
+                if (mergeLayer(d, runs) == 0)
+                    break;
+            }
+            clearLayers(d + 1);
+            if (nextBound == numeric_limits<float>::infinity())
+            {
+                filesystem::remove_all(directory);
+                path.clear();
+                return false;
+            }
+            bound = nextBound;
+        }
+    }
+};
+
+bool external_Search(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path,
+                     const string &directory, size_t bufferMegabytes, bool useHieuristic)
+{
+    ExternalSearch search(context, directory, bufferMegabytes, useHieuristic);
+    bool found = search.run(start, goal, path);
+    // Only succeeds once no other search is using the directory.
+    error_code ignored;
+    filesystem::remove(directory, ignored);
+    return found;
+}
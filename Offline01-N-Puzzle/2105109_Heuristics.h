@@ -1,132 +1,522 @@
-#include <bits/stdc++.h>
-using namespace std;
-float Hamming_Distance(vector<vector<int>> &Board)
+#pragma once
+#include "2105109_Board.h"
+
+// Boards the heuristics below can read: PackedBoards, and byte boards (one
+// tile per byte) for sides PackedBoard cannot hold.
+inline int cellTile(const PackedBoard &Board, int cell)
+{
+    return Board.get(cell);
+}
+inline int cellTile(const uint8_t *tiles, int cell)
+{
+    return tiles[cell];
+}
+
+// A child board seen as its parent, before `tile` slid from `from` into the
+// blank at `to`.
+template <class Board>
+struct ParentView
+{
+    const Board &child;
+    int tile, from, to;
+};
+
+template <class Board>
+int cellTile(const ParentView<Board> &view, int cell)
+{
+    if (cell == view.from)
+        return view.tile;
+    if (cell == view.to)
+        return 0;
+    return cellTile(view.child, cell);
+}
+
+// Hamming, Manhattan, Euclidean and Linear Conflict distances towards a target
+// board, over any board cellTile reads. The functions below measure towards
+// the standard goal, the bidirectional search towards the start board and the
+// anytime engines on byte boards of any side.
+class TargetHeuristic
 {
-    int count = 0;
-    int n = Board.size();
-    for (int i = 0; i < n; i++)
+public:
+    static const int MAX_SIDE = 15;
+    enum Kind
+    {
+        HAMMING,
+        MANHATTEN,
+        EUCLIDEAN,
+        LINEAR
+    };
+
+private:
+    int n = 0;
+    Kind kind;
+    int8_t targetRow[MAX_SIDE * MAX_SIDE];
+    int8_t targetCol[MAX_SIDE * MAX_SIDE];
+
+    double tileDistance(int tile, int cell) const
+    {
+        int dx = cell / n - targetRow[tile];
+        int dy = cell % n - targetCol[tile];
+        if (kind == HAMMING)
+            return dx != 0 || dy != 0;
+        if (kind == EUCLIDEAN)
+            return sqrt(dx * dx + dy * dy);
+        return abs(dx) + abs(dy);
+    }
+    // Only the rows and columns of the two cells touched by a move can change
+    // their conflict count.
+    template <class Board>
+    int lineConflicts(const Board &board, int from, int to) const
+    {
+        int count = rowConflicts(board, from / n) + columnConflicts(board, from % n);
+        if (to / n != from / n)
+            count += rowConflicts(board, to / n);
+        if (to % n != from % n)
+            count += columnConflicts(board, to % n);
+        return count;
+    }
+
+public:
+    // Towards the standard goal of side n.
+    TargetHeuristic(int n, Kind kind) : n(n), kind(kind)
+    {
+        for (int tile = 1; tile < n * n; tile++)
+        {
+            targetRow[tile] = (tile - 1) / n;
+            targetCol[tile] = (tile - 1) % n;
+        }
+    }
+    TargetHeuristic(const PackedBoard &target, Kind kind) : n(target.k), kind(kind)
+    {
+        for (int cell = 0; cell < n * n; cell++)
+        {
+            targetRow[target.get(cell)] = cell / n;
+            targetCol[target.get(cell)] = cell % n;
+        }
+    }
+
+    // Conflicting pairs in row i: both tiles belong to row i but sit in reversed order.
+    template <class Board>
+    int rowConflicts(const Board &board, int i) const
     {
+        int count = 0;
         for (int j = 0; j < n; j++)
         {
-            if (Board[i][j] != 0 && Board[i][j] != (i * n + j + 1))
+            int x = cellTile(board, i * n + j);
+            if (x == 0 || targetRow[x] != i)
+                continue;
+            for (int k = j + 1; k < n; k++)
             {
-                count++;
+                int y = cellTile(board, i * n + k);
+                if (y != 0 && targetRow[y] == i && targetCol[x] > targetCol[y])
+                    count++;
             }
         }
+        return count;
     }
-    return count;
-}
-float Manhatten_Distance(vector<vector<int>> &Board)
-{
-    int count = 0;
-    int n = Board.size();
-
-    for (int i = 0; i < n; i++)
+    // Conflicting pairs in column j, counted from tiles that are not already in
+    // their target row (those were counted by rowConflicts).
+    template <class Board>
+    int columnConflicts(const Board &board, int j) const
     {
-        for (int j = 0; j < n; j++)
+        int count = 0;
+        for (int i = 0; i < n; i++)
         {
-            if (Board[i][j] != 0)
+            int x = cellTile(board, i * n + j);
+            if (x == 0 || targetRow[x] == i || targetCol[x] != j)
+                continue;
+            for (int k = i + 1; k < n; k++)
             {
-                int x = Board[i][j] - 1;
-                count += abs(i - x / n) + abs(j - x % n);
+                int y = cellTile(board, k * n + j);
+                if (y != 0 && targetCol[y] == j && targetRow[x] > targetRow[y])
+                    count++;
             }
         }
+        return count;
     }
-    return count;
+
+    template <class Board>
+    float operator()(const Board &board) const
+    {
+        float count = 0;
+        for (int cell = 0; cell < n * n; cell++)
+        {
+            int tile = cellTile(board, cell);
+            if (tile != 0)
+                count += tileDistance(tile, cell);
+        }
+        if (kind == LINEAR)
+        {
+            int conflicts = 0;
+            for (int i = 0; i < n; i++)
+                conflicts += rowConflicts(board, i) + columnConflicts(board, i);
+            count += 2 * conflicts;
+        }
+        return count;
+    }
+
+    // board is the child, where `tile` slid from `from` into the blank at `to`,
+    // and parentValue the parent's value.
+    template <class Board>
+    float delta(const Board &board, float parentValue, int tile, int from, int to) const
+    {
+        float before = tileDistance(tile, from);
+        float after = tileDistance(tile, to);
+        float value = parentValue - before + after;
+        if (kind != LINEAR)
+            return value;
+        ParentView<Board> parent{board, tile, from, to};
+        return value + 2 * (lineConflicts(board, from, to) - lineConflicts(parent, from, to));
+    }
+};
+
+// The standard-goal TargetHeuristic of side k behind the functions below.
+inline const TargetHeuristic &goalHeuristic(int k, TargetHeuristic::Kind kind)
+{
+    static const vector<TargetHeuristic> heuristics = []()
+    {
+        vector<TargetHeuristic> all;
+        for (int side = 0; side <= PackedBoard::MAX_SIDE; side++)
+        {
+            for (int kind = TargetHeuristic::HAMMING; kind <= TargetHeuristic::LINEAR; kind++)
+                all.emplace_back(side, (TargetHeuristic::Kind)kind);
+        }
+        return all;
+    }();
+    return heuristics[k * (TargetHeuristic::LINEAR + 1) + kind];
 }
 
+float Hamming_Distance(const PackedBoard &Board)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::HAMMING)(Board);
+}
+float Manhatten_Distance(const PackedBoard &Board)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::MANHATTEN)(Board);
+}
+float Euclidean_Distance(const PackedBoard &Board)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::EUCLIDEAN)(Board);
+}
+float Linear_Conflict(const PackedBoard &Board)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::LINEAR)(Board);
+}
 
+// Incremental versions: Board is the child position after `tile` slid from
+// cell `from` into the blank at cell `to`, and parentValue is the heuristic of
+// the position before that move. Each returns the child's heuristic value.
+float Hamming_Distance_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int to)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::HAMMING).delta(Board, parentValue, tile, from, to);
+}
 
+float Manhatten_Distance_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int to)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::MANHATTEN).delta(Board, parentValue, tile, from, to);
+}
 
+float Euclidean_Distance_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int to)
+{
+    return goalHeuristic(Board.k, TargetHeuristic::EUCLIDEAN).delta(Board, parentValue, tile, from, to);
+}
 
-float Euclidean_Distance(vector<vector<int>> &Board)
+float Linear_Conflict_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int to)
 {
-    float count = 0;
-    int n = Board.size();
-    for (int i = 0; i < n; i++)
+    return goalHeuristic(Board.k, TargetHeuristic::LINEAR).delta(Board, parentValue, tile, from, to);
+}
+
+// Walking Distance. A row configuration counts, for every row r and goal row g,
+// the tiles in row r whose goal is row g; together with the blank's row it is a
+// state of a relaxed puzzle in which the blank swaps with any tile of a
+// neighbouring row. The BFS distance of that state to the goal configuration
+// bounds the vertical moves, and the same table read with columns in place of
+// rows bounds the horizontal ones.
+//
+// A configuration key packs the first k-1 goal-row counts of every row (three
+// bits each; the last count follows from the row size) and the blank row.
+// Configurations are numbered in BFS order, and successors gives the number
+// reached by each move of the relaxed puzzle, so a board's numbers can be
+// stepped along with its moves instead of re-encoded.
+// wd_<k>.bin caches the table: "WD1", int32 k, uint64 count, then count
+// (uint64 key, uint8 distance) pairs in BFS order.
+class WalkingDistanceTable
+{
+private:
+    // Open addressing from key to configuration number.
+    vector<uint64_t> slotKeys;
+    vector<uint16_t> slotNumbers;
+    vector<uint8_t> distances;
+    // successors[(c * k + g) * 2 + d]: configuration c after the blank swaps
+    // with a tile of goal row g from the row above (d = 0) or below (d = 1).
+    vector<uint16_t> successors;
+
+    static uint64_t encode(const int count[][PackedBoard::MAX_SIDE], int blankRow, int n)
     {
-        for (int j = 0; j < n; j++)
+        uint64_t key = blankRow;
+        for (int r = 0; r < n; r++)
         {
-            if (Board[i][j] != 0)
+            for (int g = 0; g + 1 < n; g++)
             {
-                int x = Board[i][j] - 1;
-                count += sqrt(pow(i - x / n, 2) + pow(j - x % n, 2));
+                key = key << 3 | count[r][g];
             }
         }
+        return key;
     }
-    return count;
-}
 
-float Linear_Conflict(vector<vector<int>> &Board)
-{
-    int count = 0;
-    int n = Board.size();
+    // Fills count from key and returns the blank row; the last column is what
+    // the row size leaves.
+    static int decode(uint64_t key, int count[][PackedBoard::MAX_SIDE], int n)
+    {
+        for (int r = n - 1; r >= 0; r--)
+        {
+            int total = 0;
+            for (int g = n - 2; g >= 0; g--)
+            {
+                count[r][g] = key & 7;
+                key >>= 3;
+                total += count[r][g];
+            }
+            count[r][n - 1] = n - total;
+        }
+        int blankRow = key;
+        count[blankRow][n - 1]--;
+        return blankRow;
+    }
 
-    for (int i = 0; i < n; i++)
+    // Calls visit(g, d, next) for every move of the relaxed puzzle from key.
+    template <class Visit>
+    static void forEachMove(uint64_t key, int n, Visit visit)
     {
-        for (int j = 0; j < n; j++)
+        int count[PackedBoard::MAX_SIDE][PackedBoard::MAX_SIDE];
+        int blankRow = decode(key, count, n);
+        for (int d = 0; d < 2; d++)
         {
-            if (Board[i][j] != 0)
+            int row = d == 0 ? blankRow - 1 : blankRow + 1;
+            if (row < 0 || row >= n)
+                continue;
+            for (int g = 0; g < n; g++)
             {
-                int x = Board[i][j] - 1;
-                if (i == x / n) 
-                {
-                    for (int k = j + 1; k < n; k++)
-                    {
-                        if (Board[i][k] != 0)
-                        {
-                            int y = Board[i][k] - 1;
-                            if (i == y / n && x % n > y % n) 
-                            {
-                                count += 1; 
-                            }
-                        }
-                    }
-                }
-                else if (j == x % n) 
-                {
-                    for (int k = i + 1; k < n; k++)
-                    {
-                        if (Board[k][j] != 0)
-                        {
-                            int y = Board[k][j] - 1;
-                            if (j == y % n && x / n > y / n) 
-                            {
-                                count += 1; 
-                            }
-                        }
-                    }
-                }
+                if (count[row][g] == 0)
+                    continue;
+                count[row][g]--;
+                count[blankRow][g]++;
+                visit(g, d, encode(count, row, n));
+                count[row][g]++;
+                count[blankRow][g]--;
             }
         }
     }
-    return (2*count)+Manhatten_Distance(Board);
-}
 
-int Inversion_Count(vector<vector<int>> &Board, int n)
-{
-    int count = 0;
-    vector<int> arr;
-    for (int i = 0; i < n; i++)
+    void buildIndex(const vector<pair<uint64_t, uint8_t>> &entries, int n)
     {
-        for (int j = 0; j < n; j++)
+        size_t size = 1024;
+        while (size < 2 * entries.size())
+            size *= 2;
+        slotKeys.assign(size, 0);
+        slotNumbers.assign(size, 0);
+        distances.resize(entries.size());
+        for (size_t c = 0; c < entries.size(); c++)
+        {
+            size_t i = hashBoard(entries[c].first, 0) & (size - 1);
+            while (slotKeys[i] != 0)
+                i = (i + 1) & (size - 1);
+            slotKeys[i] = entries[c].first;
+            slotNumbers[i] = c;
+            distances[c] = entries[c].second;
+        }
+        successors.assign(entries.size() * n * 2, PackedBoard::NO_CONFIGURATION);
+        for (size_t c = 0; c < entries.size(); c++)
+        {
+            forEachMove(entries[c].first, n, [&](int g, int d, uint64_t next)
+                        { successors[(c * n + g) * 2 + d] = number(next); });
+        }
+    }
+
+    static vector<pair<uint64_t, uint8_t>> generate(int n)
+    {
+        int count[PackedBoard::MAX_SIDE][PackedBoard::MAX_SIDE] = {};
+        for (int r = 0; r < n; r++)
+        {
+            count[r][r] = r + 1 < n ? n : n - 1;
+        }
+        vector<pair<uint64_t, uint8_t>> entries;
+        unordered_map<uint64_t, uint8_t> seen;
+        vector<uint64_t> queue;
+        uint64_t goalKey = encode(count, n - 1, n);
+        seen[goalKey] = 0;
+        queue.push_back(goalKey);
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            uint64_t key = queue[head];
+            uint8_t distance = seen[key];
+            entries.push_back({key, distance});
+            forEachMove(key, n, [&](int, int, uint64_t next)
+                        {
+                            if (seen.emplace(next, distance + 1).second)
+                                queue.push_back(next);
+                        });
+        }
+        return entries;
+    }
+
+public:
+    static const int MAX_SIDE = 4;
+    int k = 0;
+
+    static string defaultPath(int k)
+    {
+        return "wd_" + to_string(k) + ".bin";
+    }
+
+    // Loads wd_<k>.bin, generating and writing it first if it is missing.
+    // 5x5 has tens of millions of configurations, so tables stop at 4x4.
+    bool load(int k)
+    {
+        if (k < 2 || k > MAX_SIDE)
+            return false;
+        string path = defaultPath(k);
+        vector<pair<uint64_t, uint8_t>> entries;
+        ifstream input(path, ios::binary);
+        char magic[4];
+        int fileK = 0;
+        uint64_t size = 0;
+        if (input.read(magic, 4) && memcmp(magic, "WD1", 4) == 0 && input.read((char *)&fileK, sizeof(fileK)) && fileK == k &&
+            input.read((char *)&size, sizeof(size)))
+        {
+            entries.resize(size);
+            for (auto &entry : entries)
+            {
+                input.read((char *)&entry.first, sizeof(entry.first));
+                input.read((char *)&entry.second, sizeof(entry.second));
+            }
+        }
+        if (!input || entries.empty())
         {
-            if (Board[i][j] != 0)
+            entries = generate(k);
+            ofstream output(path, ios::binary);
+            size = entries.size();
+            output.write("WD1", 4);
+            output.write((const char *)&k, sizeof(k));
+            output.write((const char *)&size, sizeof(size));
+            for (const auto &entry : entries)
             {
-                arr.push_back(Board[i][j]);
+                output.write((const char *)&entry.first, sizeof(entry.first));
+                output.write((const char *)&entry.second, sizeof(entry.second));
             }
         }
+        buildIndex(entries, k);
+        this->k = k;
+        return true;
     }
-    for (int i = 0; i < arr.size(); i++)
+
+    uint16_t number(uint64_t key) const
     {
-        for (int j = i + 1; j < arr.size(); j++)
+        size_t mask = slotKeys.size() - 1;
+        size_t i = hashBoard(key, 0) & mask;
+        while (slotKeys[i] != key)
+            i = (i + 1) & mask;
+        return slotNumbers[i];
+    }
+    int distance(uint16_t configuration) const
+    {
+        return distances[configuration];
+    }
+
+    // Sets the board's row and column configuration numbers from its tiles.
+    void configure(const PackedBoard &Board) const
+    {
+        int n = Board.k;
+        int rows[PackedBoard::MAX_SIDE][PackedBoard::MAX_SIDE] = {};
+        int columns[PackedBoard::MAX_SIDE][PackedBoard::MAX_SIDE] = {};
+        for (int cell = 0; cell < n * n; cell++)
         {
-            if (arr[i] > arr[j])
+            int tile = Board.get(cell);
+            if (tile != 0)
             {
-                count++;
-                // cout << arr[i] << " " << arr[j] << endl;
+                rows[cell / n][(tile - 1) / n]++;
+                columns[cell % n][(tile - 1) % n]++;
             }
         }
+        Board.rowConfiguration = number(encode(rows, Board.blank / n, n));
+        Board.columnConfiguration = number(encode(columns, Board.blank % n, n));
+        Board.configurationAge = 0;
+    }
+    // Same, for a board whose numbers are from before `tile` slid from `from`
+    // into the blank at `to`: a vertical move changes only the row
+    // configuration and a horizontal one only the column configuration.
+    void step(const PackedBoard &Board, int tile, int from, int to) const
+    {
+        if (Board.configurationAge != 1 || Board.rowConfiguration == PackedBoard::NO_CONFIGURATION)
+        {
+            configure(Board);
+            return;
+        }
+        int n = Board.k;
+        int x = tile - 1;
+        if (from / n != to / n)
+            Board.rowConfiguration = successors[(Board.rowConfiguration * n + x / n) * 2 + (from / n > to / n)];
+        else
+            Board.columnConfiguration = successors[(Board.columnConfiguration * n + x % n) * 2 + (from % n > to % n)];
+        Board.configurationAge = 0;
+    }
+};
+
+inline WalkingDistanceTable walkingDistanceTables[WalkingDistanceTable::MAX_SIDE + 1];
+
+float Walking_Distance(const PackedBoard &Board)
+{
+    const WalkingDistanceTable &table = walkingDistanceTables[Board.k];
+    table.configure(Board);
+    return table.distance(Board.rowConfiguration) + table.distance(Board.columnConfiguration);
+}
+
+float Walking_Distance_Delta(const PackedBoard &Board, float, int tile, int from, int to)
+{
+    const WalkingDistanceTable &table = walkingDistanceTables[Board.k];
+    table.step(Board, tile, from, to);
+    return table.distance(Board.rowConfiguration) + table.distance(Board.columnConfiguration);
+}
+
+// Neither Walking Distance nor Linear Conflict dominates the other. Linear
+// Conflict counts every conflicting pair, as the assignment defines it, and
+// can overestimate (0 8 7 / 6 5 4 / 3 2 1 scores 30 against 28 moves), so
+// like Linear this maximum is not guaranteed to give optimal solutions.
+float Walking_Linear(const PackedBoard &Board)
+{
+    return max(Walking_Distance(Board), Linear_Conflict(Board));
+}
+
+// The parent's Linear Conflict is not recoverable from the maximum, so only
+// the Walking Distance half is incremental.
+float Walking_Linear_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int to)
+{
+    return max(Walking_Distance_Delta(Board, parentValue, tile, from, to), Linear_Conflict(Board));
+}
+
+// Inversions among the non-blank tiles in row-major order. Tiles are scanned
+// from the right and a Fenwick tree over tile values counts the smaller tiles
+// already seen, so any board size costs O(n log n).
+long long Inversion_Count(const vector<int> &tiles)
+{
+    int size = tiles.size();
+    vector<int> tree(size + 1, 0);
+    long long count = 0;
+    for (int i = size - 1; i >= 0; i--)
+    {
+        if (tiles[i] == 0)
+        {
+            continue;
+        }
+        for (int v = tiles[i] - 1; v > 0; v -= v & -v)
+        {
+            count += tree[v];
+        }
+        for (int v = tiles[i]; v <= size; v += v & -v)
+        {
+            tree[v]++;
+        }
     }
     return count;
-}
\ No newline at end of file
+}
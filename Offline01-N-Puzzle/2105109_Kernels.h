@@ -0,0 +1,186 @@
+#pragma once
+#include "2105109_Heuristics.h"
+
+// Per-size tables for the solver kernels. For a fixed side K the goal row and
+// column of every tile, the neighbours of every cell and the Manhattan distance
+// of every (tile, cell) pair are compile-time constants, so the inner loops do
+// no division and the neighbour loops have a constant trip count.
+template <int K>
+class BoardTables
+{
+public:
+    static constexpr int CELLS = K * K;
+    int8_t row[CELLS] = {};
+    int8_t col[CELLS] = {};
+    int8_t neighbourCount[CELLS] = {};
+    int8_t neighbours[CELLS][4] = {};
+    int8_t manhatten[CELLS][CELLS] = {};
+
+    constexpr BoardTables()
+    {
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            row[cell] = cell / K;
+            col[cell] = cell % K;
+        }
+        // Same order as the engines' directions: up, down, left, right.
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            int x = cell / K, y = cell % K;
+            if (x > 0)
+                neighbours[cell][neighbourCount[cell]++] = cell - K;
+            if (x < K - 1)
+                neighbours[cell][neighbourCount[cell]++] = cell + K;
+            if (y > 0)
+                neighbours[cell][neighbourCount[cell]++] = cell - 1;
+            if (y < K - 1)
+                neighbours[cell][neighbourCount[cell]++] = cell + 1;
+        }
+        // manhatten[tile][cell]; tile 0 (the blank) costs nothing.
+        for (int tile = 1; tile < CELLS; tile++)
+        {
+            for (int cell = 0; cell < CELLS; cell++)
+            {
+                int dx = cell / K - (tile - 1) / K;
+                int dy = cell % K - (tile - 1) % K;
+                manhatten[tile][cell] = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+            }
+        }
+    }
+};
+
+template <int K>
+inline constexpr BoardTables<K> boardTables{};
+
+// sqrt is not constexpr, so the Euclidean table is filled at start-up with the
+// same expression as Euclidean_Distance.
+template <int K>
+inline const array<array<float, K * K>, K * K> euclideanTable = []()
+{
+    array<array<float, K * K>, K * K> table{};
+    for (int tile = 1; tile < K * K; tile++)
+    {
+        for (int cell = 0; cell < K * K; cell++)
+        {
+            int x = tile - 1;
+            table[tile][cell] = sqrt(pow(cell / K - x / K, 2) + pow(cell % K - x % K, 2));
+        }
+    }
+    return table;
+}();
+
+// Boards up to 4x4 live in the low word, so no fifth tile bit has to be read.
+template <int K>
+inline int tileAt(const PackedBoard &Board, int cell)
+{
+    if constexpr (K <= 4)
+        return (Board.lo >> (4 * cell)) & 15;
+    else
+        return Board.get(cell);
+}
+
+// Calls visit(cell) for every cell the blank can move to. K = 0 is the generic
+// version for sizes without tables.
+template <int K, class Visit>
+inline void forEachNeighbour(const PackedBoard &Board, Visit visit)
+{
+    if constexpr (K == 0)
+    {
+        int n = Board.k;
+        int blank_x = Board.blank / n, blank_y = Board.blank % n;
+        static const int directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (auto dir : directions)
+        {
+            int new_x = blank_x + dir[0];
+            int new_y = blank_y + dir[1];
+            if (new_x >= 0 && new_x < n && new_y >= 0 && new_y < n)
+                visit(new_x * n + new_y);
+        }
+    }
+    else
+    {
+        const int8_t *cells = boardTables<K>.neighbours[Board.blank];
+        int count = boardTables<K>.neighbourCount[Board.blank];
+#pragma GCC unroll 4
+        for (int i = 0; i < 4; i++)
+        {
+            if (i < count)
+                visit(cells[i]);
+        }
+    }
+}
+
+template <int K>
+int Row_Conflicts_K(const PackedBoard &Board, int i)
+{
+    const BoardTables<K> &t = boardTables<K>;
+    int count = 0;
+    for (int j = 0; j < K; j++)
+    {
+        int tile = tileAt<K>(Board, i * K + j);
+        if (tile == 0 || t.row[tile - 1] != i)
+            continue;
+        for (int k = j + 1; k < K; k++)
+        {
+            int other = tileAt<K>(Board, i * K + k);
+            if (other != 0 && t.row[other - 1] == i && t.col[tile - 1] > t.col[other - 1])
+                count++;
+        }
+    }
+    return count;
+}
+
+template <int K>
+int Column_Conflicts_K(const PackedBoard &Board, int j)
+{
+    const BoardTables<K> &t = boardTables<K>;
+    int count = 0;
+    for (int i = 0; i < K; i++)
+    {
+        int tile = tileAt<K>(Board, i * K + j);
+        if (tile == 0 || t.row[tile - 1] == i || t.col[tile - 1] != j)
+            continue;
+        for (int k = i + 1; k < K; k++)
+        {
+            int other = tileAt<K>(Board, k * K + j);
+            if (other != 0 && t.col[other - 1] == j && t.row[tile - 1] > t.row[other - 1])
+                count++;
+        }
+    }
+    return count;
+}
+
+// Table-driven versions of the *_Delta functions of 2105109_Heuristics.h, with
+// the same arguments and results.
+template <int K>
+float Manhatten_Distance_Delta_K(const PackedBoard &, float parentValue, int tile, int from, int to)
+{
+    return parentValue - boardTables<K>.manhatten[tile][from] + boardTables<K>.manhatten[tile][to];
+}
+
+template <int K>
+float Euclidean_Distance_Delta_K(const PackedBoard &, float parentValue, int tile, int from, int to)
+{
+    return parentValue - euclideanTable<K>[tile][from] + euclideanTable<K>[tile][to];
+}
+
+template <int K>
+float Linear_Conflict_Delta_K(const PackedBoard &Board, float parentValue, int tile, int from, int to)
+{
+    PackedBoard parent = Board;
+    parent.set(from, tile);
+    parent.set(to, 0);
+
+    const BoardTables<K> &t = boardTables<K>;
+    int change = Row_Conflicts_K<K>(Board, t.row[from]) - Row_Conflicts_K<K>(parent, t.row[from]);
+    if (t.row[to] != t.row[from])
+    {
+        change += Row_Conflicts_K<K>(Board, t.row[to]) - Row_Conflicts_K<K>(parent, t.row[to]);
+    }
+    change += Column_Conflicts_K<K>(Board, t.col[from]) - Column_Conflicts_K<K>(parent, t.col[from]);
+    if (t.col[to] != t.col[from])
+    {
+        change += Column_Conflicts_K<K>(Board, t.col[to]) - Column_Conflicts_K<K>(parent, t.col[to]);
+    }
+    return Manhatten_Distance_Delta_K<K>(Board, parentValue, tile, from, to) + 2 * change;
+}
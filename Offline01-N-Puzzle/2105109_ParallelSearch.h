@@ -0,0 +1,260 @@
+#pragma once
+#include "2105109_Search.h"
+
+// Hash-distributed A* (HDA*). Every board has an owner thread picked from the
+// high bits of its hash; only the owner keeps it in an open list and a best-g
+// table. Generated children are buffered per owner and handed over in batches
+// through lock-free multi-producer single-consumer inboxes.
+//
+// A parent link is (owner, index into the owner's arena) packed into the 32-bit
+// State::parent, which caps a run at HDA_MAX_THREADS threads.
+const int HDA_OWNER_BITS = 5;
+const int HDA_MAX_THREADS = 1 << HDA_OWNER_BITS;
+const uint32_t HDA_INDEX_MASK = (1u << (32 - HDA_OWNER_BITS)) - 1;
+const int HDA_EXPANSION_SLICE = 64;
+
+struct HdaMessage
+{
+    PackedBoard board;
+    float hieuristic;
+    int moves;
+    uint32_t parent;
+};
+
+struct HdaBatch
+{
+    vector<HdaMessage> messages;
+    HdaBatch *next = nullptr;
+};
+
+// Producers push whole batches onto a Treiber stack; the owner detaches the
+// entire stack with one exchange, so there is no ABA problem on the pop side.
+class HdaInbox
+{
+private:
+    atomic<HdaBatch *> head{nullptr};
+
+public:
+    void push(HdaBatch *batch)
+    {
+        batch->next = head.load(memory_order_relaxed);
+        while (!head.compare_exchange_weak(batch->next, batch, memory_order_release, memory_order_relaxed))
+        {
+        }
+    }
+    HdaBatch *takeAll()
+    {
+        return head.exchange(nullptr, memory_order_acquire);
+    }
+    bool empty() const
+    {
+        return head.load(memory_order_acquire) == nullptr;
+    }
+};
+
+template <class OpenList>
+class ParallelAStar
+{
+private:
+    struct Worker
+    {
+        NodeArena arena;
+        PackedBoardMap bestMoves;
+        HdaInbox inbox;
+        vector<vector<HdaMessage>> outbox;
+        long long noOfExploredStates = 0;
+        long long noOfExpandedStates = 0;
+    };
+
+    int threads;
+    PackedBoard goal;
+    HeuristicFunction heuristic;
+    HeuristicDelta heuristicDelta;
+    vector<unique_ptr<Worker>> workers;
+
+    // Threads that are busy plus batches sent but not yet consumed. It only
+    // reaches zero when every thread is idle and no work is in flight, and it
+    // cannot rise again from there, so zero means the search is over.
+    atomic<long long> pending{0};
+    atomic<int> incumbent{INT_MAX};
+    mutex incumbentLock;
+    uint32_t goalNode = NodeArena::NONE;
+
+    int ownerOf(const PackedBoard &board) const
+    {
+        return (hashBoard(board.lo, board.hi) >> 40) % threads;
+    }
+
+    void accept(Worker &self, OpenList &open, int id, const HdaMessage &message)
+    {
+        if (message.moves + message.hieuristic >= incumbent.load(memory_order_relaxed))
+            return;
+        bool inserted;
+        uint32_t &best = self.bestMoves.emplace(message.board, message.moves, inserted);
+        if (!inserted && (int)best <= message.moves)
+            return;
+        best = message.moves;
+        if (self.arena.size() >= HDA_INDEX_MASK)
+        {
+            cerr << "HDA*: node arena of thread " << id << " is full\n";
+            abort();
+        }
+        int priority = max(0, message.moves - 1) + (int)message.hieuristic;
+        open.push(self.arena.add(message.board, priority, message.hieuristic, message.moves, message.parent));
+        self.noOfExploredStates++;
+    }
+
+    void flush(Worker &self, int destination)
+    {
+        if (self.outbox[destination].empty())
+            return;
+        HdaBatch *batch = new HdaBatch;
+        batch->messages.swap(self.outbox[destination]);
+        pending.fetch_add(1);
+        workers[destination]->inbox.push(batch);
+    }
+
+    void expand(Worker &self, OpenList &open, int id, uint32_t current)
+    {
+        State currentState = self.arena[current];
+        const PackedBoard &currentBoard = currentState.getBoard();
+        if (currentState.getMoves() + currentState.hieuristic >= incumbent.load(memory_order_relaxed))
+            return;
+        if ((int)*self.bestMoves.find(currentBoard) < currentState.getMoves())
+            return;
+        if (currentBoard == goal)
+        {
+            lock_guard<mutex> guard(incumbentLock);
+            if (currentState.getMoves() < incumbent.load())
+            {
+                incumbent.store(currentState.getMoves());
+                goalNode = ((uint32_t)id << (32 - HDA_OWNER_BITS)) | current;
+            }
+            return;
+        }
+        self.noOfExpandedStates++;
+
+        int n = currentBoard.k;
+        auto [blank_x, blank_y] = getBlankTilePosition(currentBoard);
+        static const int directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        uint32_t parent = ((uint32_t)id << (32 - HDA_OWNER_BITS)) | current;
+        for (auto dir : directions)
+        {
+            int new_x = blank_x + dir[0];
+            int new_y = blank_y + dir[1];
+            if (new_x < 0 || new_x >= n || new_y < 0 || new_y >= n)
+                continue;
+            int cell = new_x * n + new_y;
+            HdaMessage message;
+            message.board = currentBoard;
+            message.board.moveBlank(cell);
+            message.hieuristic = childHieuristic(message.board, currentState.hieuristic, currentBoard.get(cell), cell, currentBoard.blank);
+            message.moves = currentState.getMoves() + 1;
+            message.parent = parent;
+
+            int owner = ownerOf(message.board);
+            if (owner == id)
+                accept(self, open, id, message);
+            else
+                self.outbox[owner].push_back(message);
+        }
+    }
+
+    void work(int id, const PackedBoard &start)
+    {
+        hieuristics = heuristic;
+        hieuristicsDelta = heuristicDelta;
+        Worker &self = *workers[id];
+        OpenList open(self.arena);
+        if (ownerOf(start) == id)
+        {
+            accept(self, open, id, HdaMessage{start, hieuristics(start), 0, NodeArena::NONE});
+        }
+
+        while (true)
+        {
+            long long consumed = 0;
+            for (HdaBatch *batch = self.inbox.takeAll(); batch != nullptr; consumed++)
+            {
+                for (const auto &message : batch->messages)
+                    accept(self, open, id, message);
+                HdaBatch *next = batch->next;
+                delete batch;
+                batch = next;
+            }
+            if (consumed > 0)
+                pending.fetch_sub(consumed);
+
+            for (int slice = 0; slice < HDA_EXPANSION_SLICE && !open.empty(); slice++)
+            {
+                expand(self, open, id, open.pop());
+            }
+            for (int destination = 0; destination < threads; destination++)
+            {
+                flush(self, destination);
+            }
+            if (!open.empty() || !self.inbox.empty())
+                continue;
+
+            pending.fetch_sub(1);
+            while (true)
+            {
+                if (!self.inbox.empty())
+                {
+                    pending.fetch_add(1);
+                    break;
+                }
+                if (pending.load() == 0)
+                    return;
+                this_thread::yield();
+            }
+        }
+    }
+
+public:
+    bool run(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path, int threads)
+    {
+        this->threads = min(max(threads, 1), HDA_MAX_THREADS);
+        this->goal = goal;
+        heuristic = hieuristics;
+        heuristicDelta = hieuristicsDelta;
+        for (int i = 0; i < this->threads; i++)
+        {
+            workers.emplace_back(new Worker);
+            workers.back()->outbox.resize(this->threads);
+        }
+        pending.store(this->threads);
+
+        vector<thread> pool;
+        for (int i = 0; i < this->threads; i++)
+        {
+            pool.emplace_back(&ParallelAStar::work, this, i, start);
+        }
+        for (auto &t : pool)
+        {
+            t.join();
+        }
+
+        for (auto &worker : workers)
+        {
+            context.noOfExploredStates += worker->noOfExploredStates;
+            context.noOfExpandedStates += worker->noOfExpandedStates;
+        }
+        path.clear();
+        for (uint32_t node = goalNode; node != NodeArena::NONE;)
+        {
+            const State &state = workers[node >> (32 - HDA_OWNER_BITS)]->arena[node & HDA_INDEX_MASK];
+            path.push_back(state.getBoard());
+            node = state.getParent();
+        }
+        reverse(path.begin(), path.end());
+        return goalNode != NodeArena::NONE;
+    }
+};
+
+template <class OpenList>
+bool hda_Star(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path, int threads)
+{
+    ParallelAStar<OpenList> search;
+    return search.run(context, start, goal, path, threads);
+}
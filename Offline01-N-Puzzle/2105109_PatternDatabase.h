@@ -0,0 +1,397 @@
+#pragma once
+#include "2105109_Board.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Disjoint additive pattern databases. Each group of tiles has a table holding,
+// for every placement of those tiles, the number of moves of group tiles needed
+// to bring them home (blank moves through other cells are free). Since no move
+// is counted by two groups, the values of all groups can be added.
+//
+// Placements are ranked as partial permutations: position i of m chosen cells
+// out of n is a digit in base (n - i), counting only cells not chosen before.
+inline uint64_t rankPositions(const int *positions, int m, int n)
+{
+    uint64_t rank = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < m; i++)
+    {
+        int smaller = __builtin_popcount(used & ((1u << positions[i]) - 1));
+        rank = rank * (n - i) + positions[i] - smaller;
+        used |= 1u << positions[i];
+    }
+    return rank;
+}
+
+inline void unrankPositions(uint64_t rank, int *positions, int m, int n)
+{
+    int digits[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+    for (int i = m - 1; i >= 0; i--)
+    {
+        digits[i] = rank % (n - i);
+        rank /= (n - i);
+    }
+    uint32_t used = 0;
+    for (int i = 0; i < m; i++)
+    {
+        int cell = 0;
+        for (int skip = digits[i];; cell++)
+        {
+            if (used & (1u << cell))
+                continue;
+            if (skip-- == 0)
+                break;
+        }
+        positions[i] = cell;
+        used |= 1u << cell;
+    }
+}
+
+inline uint64_t placementCount(int m, int n)
+{
+    uint64_t count = 1;
+    for (int i = 0; i < m; i++)
+    {
+        count *= n - i;
+    }
+    return count;
+}
+
+// Connected regions of free cells of a k x k board, as bit sets of cells.
+// Regions are numbered by their lowest cell. m tiles split the board into at
+// most min(2m, n - m) regions, which is at most 16 for boards up to 5x5.
+class BlankRegions
+{
+private:
+    int k;
+    uint32_t notFirstColumn = 0;
+    uint32_t notLastColumn = 0;
+
+public:
+    uint32_t cells;
+
+    BlankRegions(int k) : k(k)
+    {
+        cells = (uint32_t)((1ull << (k * k)) - 1);
+        for (int cell = 0; cell < k * k; cell++)
+        {
+            if (cell % k != 0)
+                notFirstColumn |= 1u << cell;
+            if (cell % k != k - 1)
+                notLastColumn |= 1u << cell;
+        }
+    }
+
+    // Cells next to any cell of set, and set itself.
+    uint32_t grow(uint32_t set) const
+    {
+        return (set | set << k | set >> k | (set & notLastColumn) << 1 | (set & notFirstColumn) >> 1) & cells;
+    }
+    uint32_t flood(uint32_t seed, uint32_t open) const
+    {
+        for (uint32_t reached = 0; reached != seed;)
+        {
+            reached = seed;
+            seed = grow(seed) & open;
+        }
+        return seed;
+    }
+    int index(uint32_t region, uint32_t open) const
+    {
+        int index = 0;
+        for (uint32_t lower = open & ((region & -region) - 1); lower != 0; index++)
+        {
+            lower &= ~flood(lower & -lower, open);
+        }
+        return index;
+    }
+};
+
+// File layout (native byte order):
+//   "PDB1", int32 k, int32 groupCount,
+//   per group: int32 size, int32 tiles[size], uint64 entries,
+//   then every group's table of uint8 distances, in group order.
+class PatternDatabase
+{
+private:
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+
+public:
+    int k = 0;
+    vector<vector<int>> groups;
+    vector<const uint8_t *> tables;
+    int groupOfTile[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+
+    ~PatternDatabase()
+    {
+        unload();
+    }
+
+    static string defaultPath(int k)
+    {
+        return "pdb_" + to_string(k) + ".bin";
+    }
+
+    // The 5x5 groups have 25P6 = 127.5M placements each; building one takes
+    // about 800 MB and a few minutes.
+    static vector<vector<int>> defaultGroups(int k)
+    {
+        if (k == 3)
+            return {{1, 2, 3, 4}, {5, 6, 7, 8}};
+        if (k == 4)
+            return {{1, 5, 6, 9, 10, 13}, {7, 8, 11, 12, 14, 15}, {2, 3, 4}};
+        if (k == 5)
+            return {{1, 2, 3, 6, 7, 8}, {4, 5, 9, 10, 14, 15}, {11, 12, 16, 17, 21, 22}, {13, 18, 19, 20, 23, 24}};
+        return {};
+    }
+
+    // Backward breadth-first search from the goal over (placement of the group
+    // tiles, region of the blank). Blank moves that do not touch a group tile
+    // are free, so all blank cells of one free region are the same state; a
+    // move slides a group tile into a cell of the blank's region. Visited
+    // states are one bit per region of each placement and the frontier holds
+    // rank * n + blank cell, so memory is about three bytes per placement plus
+    // two frontier layers rather than a byte per (placement, blank cell).
+    static vector<uint8_t> buildTable(int k, const vector<int> &group)
+    {
+        int n = k * k;
+        int m = group.size();
+        BlankRegions regions(k);
+        uint64_t placements = placementCount(m, n);
+        vector<uint8_t> table(placements, 255);
+        vector<uint16_t> seen(placements, 0);
+        vector<uint64_t> frontier, next;
+
+        int positions[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+        uint32_t occupied = 0;
+        for (int i = 0; i < m; i++)
+        {
+            positions[i] = group[i] - 1;
+            occupied |= 1u << positions[i];
+        }
+        uint64_t goal = rankPositions(positions, m, n);
+        table[goal] = 0;
+        uint32_t open = regions.cells & ~occupied;
+        for (uint32_t rest = open; rest != 0;)
+        {
+            uint32_t region = regions.flood(rest & -rest, open);
+            seen[goal] |= 1 << regions.index(region, open);
+            frontier.push_back(goal * n + __builtin_ctz(rest));
+            rest &= ~region;
+        }
+
+        for (int depth = 1; !frontier.empty(); depth++)
+        {
+            next.clear();
+            for (uint64_t state : frontier)
+            {
+                uint64_t rank = state / n;
+                int blank = state % n;
+                unrankPositions(rank, positions, m, n);
+                occupied = 0;
+                for (int i = 0; i < m; i++)
+                {
+                    occupied |= 1u << positions[i];
+                }
+                open = regions.cells & ~occupied;
+                uint32_t region = regions.flood(1u << blank, open);
+                uint32_t border = regions.grow(region) & occupied;
+                for (int i = 0; i < m; i++)
+                {
+                    int from = positions[i];
+                    if ((border & (1u << from)) == 0)
+                        continue;
+                    for (uint32_t targets = regions.grow(1u << from) & region; targets != 0; targets &= targets - 1)
+                    {
+                        int to = __builtin_ctz(targets);
+                        positions[i] = to;
+                        uint64_t nextRank = rankPositions(positions, m, n);
+                        uint32_t nextOpen = (open | (1u << from)) & ~(1u << to);
+                        uint16_t bit = 1 << regions.index(regions.flood(1u << from, nextOpen), nextOpen);
+                        if ((seen[nextRank] & bit) == 0)
+                        {
+                            seen[nextRank] |= bit;
+                            table[nextRank] = min<int>(table[nextRank], depth);
+                            next.push_back(nextRank * n + from);
+                        }
+                    }
+                    positions[i] = from;
+                }
+            }
+            swap(frontier, next);
+        }
+        return table;
+    }
+
+    static bool build(int k, const vector<vector<int>> &groups, const string &path)
+    {
+        ofstream file(path, ios::binary);
+        if (!file.is_open())
+            return false;
+
+        int header[2] = {k, (int)groups.size()};
+        file.write("PDB1", 4);
+        file.write((const char *)header, sizeof(header));
+        for (const auto &group : groups)
+        {
+            int size = group.size();
+            uint64_t entries = placementCount(size, k * k);
+            file.write((const char *)&size, sizeof(size));
+            file.write((const char *)group.data(), size * sizeof(int));
+            file.write((const char *)&entries, sizeof(entries));
+        }
+        for (const auto &group : groups)
+        {
+            vector<uint8_t> table = buildTable(k, group);
+            file.write((const char *)table.data(), table.size());
+        }
+        return file.good();
+    }
+
+    // Maps the file read-only and shared, so concurrent solver processes use
+    // the same page-cache copy of the tables. The whole layout is checked
+    // against the file size before anything is kept, so a truncated file (or
+    // one BuildPDB is still writing) leaves the database unloaded.
+    bool load(const string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) < 0 || info.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        size_t size = info.st_size;
+        void *file = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (file == MAP_FAILED)
+            return false;
+
+        const char *data = (const char *)file;
+        size_t offset = 12;
+        int fileK = 0, groupCount = 0;
+        bool valid = size >= offset && memcmp(data, "PDB1", 4) == 0;
+        if (valid)
+        {
+            memcpy(&fileK, data + 4, sizeof(int));
+            memcpy(&groupCount, data + 8, sizeof(int));
+            valid = fileK >= 2 && fileK <= PackedBoard::MAX_SIDE && groupCount >= 0 && groupCount < fileK * fileK;
+        }
+        vector<vector<int>> fileGroups;
+        uint64_t tableBytes = 0;
+        for (int g = 0; valid && g < groupCount; g++)
+        {
+            int groupSize;
+            valid = size - offset >= sizeof(int);
+            if (valid)
+            {
+                memcpy(&groupSize, data + offset, sizeof(int));
+                offset += sizeof(int);
+                valid = groupSize > 0 && groupSize < fileK * fileK && size - offset >= groupSize * sizeof(int) + sizeof(uint64_t);
+            }
+            if (!valid)
+                break;
+            vector<int> group(groupSize);
+            memcpy(group.data(), data + offset, groupSize * sizeof(int));
+            offset += groupSize * sizeof(int);
+            uint64_t count;
+            memcpy(&count, data + offset, sizeof(count));
+            offset += sizeof(count);
+            for (int tile : group)
+            {
+                valid = valid && tile >= 1 && tile < fileK * fileK;
+            }
+            valid = valid && count == placementCount(groupSize, fileK * fileK);
+            tableBytes += count;
+            fileGroups.push_back(group);
+        }
+        if (!valid || size - offset != tableBytes)
+        {
+            munmap(file, size);
+            return false;
+        }
+
+        unload();
+        mapping = file;
+        mappingSize = size;
+        k = fileK;
+        groups = fileGroups;
+        fill(groupOfTile, groupOfTile + PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE, -1);
+        for (int g = 0; g < groupCount; g++)
+        {
+            for (int tile : groups[g])
+            {
+                groupOfTile[tile] = g;
+            }
+            tables.push_back((const uint8_t *)data + offset);
+            offset += placementCount(groups[g].size(), k * k);
+        }
+        return true;
+    }
+
+    void unload()
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+        k = 0;
+        groups.clear();
+        tables.clear();
+    }
+
+    int lookup(int g, const int *tileCell) const
+    {
+        int positions[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+        int m = groups[g].size();
+        for (int i = 0; i < m; i++)
+        {
+            positions[i] = tileCell[groups[g][i]];
+        }
+        return tables[g][rankPositions(positions, m, k * k)];
+    }
+};
+
+// One database per board side, so solves of different sizes can share a process.
+inline PatternDatabase patternDatabases[PackedBoard::MAX_SIDE + 1];
+
+float Pattern_Database(const PackedBoard &Board)
+{
+    const PatternDatabase &patternDatabase = patternDatabases[Board.k];
+    int n = Board.k * Board.k;
+    int tileCell[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+    for (int cell = 0; cell < n; cell++)
+    {
+        tileCell[Board.get(cell)] = cell;
+    }
+    int count = 0;
+    for (int g = 0; g < (int)patternDatabase.groups.size(); g++)
+    {
+        count += patternDatabase.lookup(g, tileCell);
+    }
+    return count;
+}
+
+// Only the moved tile's group changes its entry.
+float Pattern_Database_Delta(const PackedBoard &Board, float parentValue, int tile, int from, int)
+{
+    const PatternDatabase &patternDatabase = patternDatabases[Board.k];
+    int g = patternDatabase.groupOfTile[tile];
+    if (g < 0)
+        return parentValue;
+    int n = Board.k * Board.k;
+    int tileCell[PackedBoard::MAX_SIDE * PackedBoard::MAX_SIDE];
+    for (int cell = 0; cell < n; cell++)
+    {
+        tileCell[Board.get(cell)] = cell;
+    }
+    int after = patternDatabase.lookup(g, tileCell);
+    tileCell[tile] = from;
+    int before = patternDatabase.lookup(g, tileCell);
+    return parentValue - before + after;
+}
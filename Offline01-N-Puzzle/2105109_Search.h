@@ -0,0 +1,492 @@
+#pragma once
+#include "2105109_Kernels.h"
+#include "2105109_Trace.h"
+
+typedef float (*HeuristicFunction)(const PackedBoard &);
+typedef float (*HeuristicDelta)(const PackedBoard &, float, int, int, int);
+// Per thread, so concurrent solves can use different heuristics. Code that
+// starts helper threads for one solve hands its pointers on to them.
+thread_local HeuristicFunction hieuristics = nullptr;
+thread_local HeuristicDelta hieuristicsDelta = nullptr;
+
+// Swaps a generic delta for its table-driven version for side K, if it has one.
+// hieuristics itself stays generic: it runs once per search and is what the
+// rest of the code compares against to tell the heuristics apart.
+template <int K>
+HeuristicDelta specializeDelta(HeuristicDelta delta)
+{
+    if (delta == Manhatten_Distance_Delta)
+        return Manhatten_Distance_Delta_K<K>;
+    if (delta == Euclidean_Distance_Delta)
+        return Euclidean_Distance_Delta_K<K>;
+    if (delta == Linear_Conflict_Delta)
+        return Linear_Conflict_Delta_K<K>;
+    return delta;
+}
+
+HeuristicDelta specializeDelta(HeuristicDelta delta, int k)
+{
+    switch (k)
+    {
+    case 3:
+        return specializeDelta<3>(delta);
+    case 4:
+        return specializeDelta<4>(delta);
+    case 5:
+        return specializeDelta<5>(delta);
+    default:
+        return delta;
+    }
+}
+
+// Heuristic of the child reached by sliding `tile` from `from` into the blank at
+// `to`, updated from the parent's value. Building with -DDEBUG_HEURISTICS checks
+// every update against a full recomputation.
+float childHieuristic(const PackedBoard &newBoard, float parentValue, int tile, int from, int to)
+{
+    float value = hieuristicsDelta(newBoard, parentValue, tile, from, to);
+#ifdef DEBUG_HEURISTICS
+    float full = hieuristics(newBoard);
+    if (fabs(full - value) > 1e-3 * max(1.0f, full))
+    {
+        cerr << "Heuristic delta mismatch: incremental " << value << ", full " << full << "\n";
+        abort();
+    }
+#endif
+    return value;
+}
+
+class State
+{
+public:
+    PackedBoard Board;
+    int priority;
+    float hieuristic;
+    int moves;
+    uint32_t parent;
+
+    State() = default;
+    State(const PackedBoard &Board, int priority, float hieuristic, int moves, uint32_t parent)
+    {
+        this->Board = Board;
+        this->priority = priority;
+        this->hieuristic = hieuristic;
+        this->moves = moves;
+        this->parent = parent;
+    }
+    const PackedBoard &getBoard() const
+    {
+        return Board;
+    }
+    int getPriority() const
+    {
+        return priority;
+    }
+    int getMoves() const
+    {
+        return moves;
+    }
+    uint32_t getParent() const
+    {
+        return parent;
+    }
+};
+
+// Search nodes are carved out of fixed-size slabs and link to their parent by
+// index. reset() drops every node of a solve at once but keeps the slabs, so
+// the next solve reuses them without touching the heap.
+class NodeArena
+{
+private:
+    static const uint32_t CHUNK_BITS = 16;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+    vector<unique_ptr<State[]>> chunks;
+    uint32_t count = 0;
+
+public:
+    static const uint32_t NONE = UINT32_MAX;
+
+    uint32_t add(const PackedBoard &Board, int priority, float hieuristic, int moves, uint32_t parent)
+    {
+        if ((count >> CHUNK_BITS) == chunks.size())
+        {
+            chunks.emplace_back(new State[CHUNK_SIZE]);
+        }
+        (*this)[count] = State(Board, priority, hieuristic, moves, parent);
+        return count++;
+    }
+    State &operator[](uint32_t index)
+    {
+        return chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+    }
+    const State &operator[](uint32_t index) const
+    {
+        return chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+    }
+    uint32_t size() const
+    {
+        return count;
+    }
+    size_t bytes() const
+    {
+        return chunks.size() * CHUNK_SIZE * sizeof(State);
+    }
+    void reset()
+    {
+        count = 0;
+    }
+    void release()
+    {
+        chunks.clear();
+        count = 0;
+    }
+};
+pair<int, int> getBlankTilePosition(const PackedBoard &Board)
+{
+    return {Board.blank / Board.k, Board.blank % Board.k};
+}
+struct CompareState
+{
+    const NodeArena *arena;
+
+    bool operator()(uint32_t x, uint32_t y) const
+    {
+        const State &a = (*arena)[x];
+        const State &b = (*arena)[y];
+        if (a.priority == b.priority)
+        {
+            return a.hieuristic > b.hieuristic;
+        }
+        return a.priority > b.priority;
+    }
+};
+
+// Fallback open list for the float-valued Euclidean heuristic.
+class HeapOpenList
+{
+private:
+    priority_queue<uint32_t, vector<uint32_t>, CompareState> pq;
+
+public:
+    HeapOpenList(const NodeArena &arena) : pq(CompareState{&arena}) {}
+
+    void push(uint32_t index)
+    {
+        pq.push(index);
+    }
+    uint32_t pop()
+    {
+        uint32_t index = pq.top();
+        pq.pop();
+        return index;
+    }
+    bool empty() const
+    {
+        return pq.empty();
+    }
+    size_t size() const
+    {
+        return pq.size();
+    }
+};
+
+// Open list for integer heuristics. Nodes are filed under buckets[priority][h]
+// and taken from the lowest non-empty bucket, which is the order CompareState
+// gives, with O(1) amortised push and pop. minHieuristic[f] is a lower bound on
+// the smallest non-empty h bucket of priority f.
+class BucketOpenList
+{
+private:
+    const NodeArena &arena;
+    vector<vector<vector<uint32_t>>> buckets;
+    vector<int> minHieuristic;
+    int minPriority = INT_MAX;
+    size_t count = 0;
+
+public:
+    BucketOpenList(const NodeArena &arena) : arena(arena) {}
+
+    void push(uint32_t index)
+    {
+        const State &state = arena[index];
+        int f = state.priority;
+        int h = (int)state.hieuristic;
+        if (f >= (int)buckets.size())
+        {
+            buckets.resize(f + 1);
+            minHieuristic.resize(f + 1, INT_MAX);
+        }
+        if (h >= (int)buckets[f].size())
+        {
+            buckets[f].resize(h + 1);
+        }
+        buckets[f][h].push_back(index);
+        minHieuristic[f] = min(minHieuristic[f], h);
+        minPriority = min(minPriority, f);
+        count++;
+    }
+    uint32_t pop()
+    {
+        while (true)
+        {
+            vector<vector<uint32_t>> &bucket = buckets[minPriority];
+            int &h = minHieuristic[minPriority];
+            while (h < (int)bucket.size() && bucket[h].empty())
+            {
+                h++;
+            }
+            if (h < (int)bucket.size())
+            {
+                uint32_t index = bucket[h].back();
+                bucket[h].pop_back();
+                count--;
+                return index;
+            }
+            h = INT_MAX;
+            minPriority++;
+        }
+    }
+    bool empty() const
+    {
+        return count == 0;
+    }
+    size_t size() const
+    {
+        return count;
+    }
+};
+
+// Everything one solve touches. Workers in batch mode each own a context and
+// reuse it, so the arena slabs stay allocated between puzzles.
+class SolveContext
+{
+public:
+    // Fewest moves found so far to each board the A* kernel has generated.
+    PackedBoardMap bestMoves;
+    NodeArena arena;
+    long long noOfExploredStates = 0;
+    long long noOfExpandedStates = 0;
+    SearchTrace trace;
+
+    size_t bytes() const
+    {
+        return bestMoves.bytes() + arena.bytes();
+    }
+    // Drops the nodes of the finished search; the counters stay for reporting.
+    void releaseNodes()
+    {
+        bestMoves.clear();
+        arena.reset();
+    }
+    void reset()
+    {
+        releaseNodes();
+        noOfExploredStates = 0;
+        noOfExpandedStates = 0;
+        trace.reset();
+    }
+};
+
+vector<PackedBoard> tracePath(const NodeArena &arena, uint32_t goal)
+{
+    uint32_t current = goal;
+    vector<PackedBoard> path;
+    while (current != NodeArena::NONE)
+    {
+        path.push_back(arena[current].getBoard());
+        current = arena[current].getParent();
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// Both engines fill `path` with the boards from start to goal and return
+// whether the goal was reached. Each is compiled per board side K (0 = any
+// side) and a_Star/ida_Star pick the instantiation for the start board.
+template <int K, class OpenList>
+bool a_Star_Kernel(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+{
+    NodeArena &arena = context.arena;
+    PackedBoardMap &bestMoves = context.bestMoves;
+    SearchTrace &trace = context.trace;
+    OpenList pq(arena);
+    bool startInserted;
+    bestMoves.emplace(start, 0, startInserted);
+    pq.push(arena.add(start, 0, hieuristics(start), 0, NodeArena::NONE));
+    context.noOfExploredStates++;
+
+    while (!pq.empty())
+    {
+        uint32_t current;
+        {
+            auto timer = trace.time(SearchTrace::QUEUE);
+            current = pq.pop();
+        }
+        // A board is queued again whenever a shorter path to it turns up, and
+        // only the copy with its fewest known moves is expanded. Reopening keeps
+        // the result optimal for heuristics that are admissible but not
+        // consistent, such as the pattern databases.
+        bool stale;
+        {
+            auto timer = trace.time(SearchTrace::DUPLICATE_CHECK);
+            stale = (int)*bestMoves.find(arena[current].getBoard()) < arena[current].getMoves();
+        }
+        trace.duplicate(stale);
+        if (stale)
+        {
+            continue;
+        }
+        context.noOfExpandedStates++;
+        State currentState = arena[current];
+        trace.expand(currentState.getMoves() + currentState.hieuristic, pq.size(), context.bytes());
+        // PrintBoard(currentState->getBoard());
+
+        if (currentState.getBoard() == goal)
+        {
+            auto timer = trace.time(SearchTrace::PATH);
+            path = tracePath(arena, current);
+            context.releaseNodes();
+            return true;
+        }
+
+        const PackedBoard &currentBoard = currentState.getBoard();
+        forEachNeighbour<K>(currentBoard, [&](int cell)
+                            {
+                                PackedBoard newBoard = currentBoard;
+                                newBoard.moveBlank(cell);
+
+                                bool shorter;
+                                {
+                                    auto timer = trace.time(SearchTrace::DUPLICATE_CHECK);
+                                    bool inserted;
+                                    uint32_t &best = bestMoves.emplace(newBoard, currentState.getMoves() + 1, inserted);
+                                    shorter = inserted || (int)best > currentState.getMoves() + 1;
+                                    best = min<int>(best, currentState.getMoves() + 1);
+                                }
+                                trace.duplicate(!shorter);
+                                if (shorter)
+                                {
+                                    int tile = tileAt<K>(currentBoard, cell);
+                                    float newHieuristic;
+                                    {
+                                        auto timer = trace.time(SearchTrace::HEURISTIC);
+                                        newHieuristic = childHieuristic(newBoard, currentState.hieuristic, tile, cell, currentBoard.blank);
+                                    }
+
+                                    int newPriority = currentState.getMoves() + (int)newHieuristic; // Update priority (can include heuristic)
+                                    auto timer = trace.time(SearchTrace::QUEUE);
+                                    pq.push(arena.add(newBoard, newPriority, newHieuristic, currentState.getMoves() + 1, current));
+                                    context.noOfExploredStates++;
+                                }
+                            });
+    }
+    context.releaseNodes();
+    return false;
+}
+
+template <class OpenList>
+bool a_Star(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+{
+    switch (start.k)
+    {
+    case 3:
+        return a_Star_Kernel<3, OpenList>(context, start, goal, path);
+    case 4:
+        return a_Star_Kernel<4, OpenList>(context, start, goal, path);
+    case 5:
+        return a_Star_Kernel<5, OpenList>(context, start, goal, path);
+    default:
+        return a_Star_Kernel<0, OpenList>(context, start, goal, path);
+    }
+}
+
+// IDA*: depth-first search bounded by f = g + h, restarted with the smallest f
+// that exceeded the previous bound. Only the current path is kept in memory.
+const float IDA_FOUND = -1;
+
+template <int K>
+float ida_Search(SolveContext &context, vector<PackedBoard> &path, int moves, float hieuristic, float bound, int previousBlank, const PackedBoard &goal)
+{
+    PackedBoard currentBoard = path.back();
+    float f = moves + hieuristic;
+    if (f > bound)
+    {
+        return f;
+    }
+    if (currentBoard == goal)
+    {
+        return IDA_FOUND;
+    }
+    context.noOfExpandedStates++;
+    context.trace.expand(f, path.size(), 0);
+
+    float minimum = numeric_limits<float>::infinity();
+    bool found = false;
+    forEachNeighbour<K>(currentBoard, [&](int cell)
+                        {
+                            // moving the blank back to where it came from only undoes the parent move
+                            if (found || cell == previousBlank)
+                            {
+                                return;
+                            }
+                            PackedBoard newBoard = currentBoard;
+                            newBoard.moveBlank(cell);
+                            context.noOfExploredStates++;
+                            int tile = tileAt<K>(currentBoard, cell);
+                            float newHieuristic;
+                            {
+                                auto timer = context.trace.time(SearchTrace::HEURISTIC);
+                                newHieuristic = childHieuristic(newBoard, hieuristic, tile, cell, currentBoard.blank);
+                            }
+
+                            path.push_back(newBoard);
+                            float t = ida_Search<K>(context, path, moves + 1, newHieuristic, bound, currentBoard.blank, goal);
+                            if (t == IDA_FOUND)
+                            {
+                                found = true;
+                                return;
+                            }
+                            minimum = min(minimum, t);
+                            path.pop_back();
+                        });
+    return found ? IDA_FOUND : minimum;
+}
+
+template <int K>
+bool ida_Star_Kernel(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+{
+    path = {start};
+    context.noOfExploredStates++;
+    float startHieuristic = hieuristics(start);
+    float bound = startHieuristic;
+
+    while (true)
+    {
+        float t = ida_Search<K>(context, path, 0, startHieuristic, bound, -1, goal);
+        if (t == IDA_FOUND)
+        {
+            return true;
+        }
+        if (t == numeric_limits<float>::infinity())
+        {
+            path.clear();
+            return false;
+        }
+        bound = t;
+    }
+}
+
+bool ida_Star(SolveContext &context, const PackedBoard &start, const PackedBoard &goal, vector<PackedBoard> &path)
+{
+    switch (start.k)
+    {
+    case 3:
+        return ida_Star_Kernel<3>(context, start, goal, path);
+    case 4:
+        return ida_Star_Kernel<4>(context, start, goal, path);
+    case 5:
+        return ida_Star_Kernel<5>(context, start, goal, path);
+    default:
+        return ida_Star_Kernel<0>(context, start, goal, path);
+    }
+}
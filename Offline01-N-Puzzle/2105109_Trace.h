@@ -0,0 +1,163 @@
+#pragma once
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+using namespace std;
+
+// Instrumentation of one solve, reported as a JSON object. It is compiled in
+// only with -DSEARCH_TRACE; otherwise SearchTrace is an empty class whose
+// methods do nothing and every call in the engines compiles away.
+//
+// Engines call time() around the work they want attributed to a phase,
+// duplicate() for every closed-list lookup and expand() for every expanded
+// node; solve() adds the heuristic error along the solution path. A trace
+// belongs to one thread, so the parallel engines are not traced.
+class SearchTrace
+{
+public:
+    enum Phase
+    {
+        HEURISTIC,
+        DUPLICATE_CHECK,
+        QUEUE,
+        PATH,
+        PHASES
+    };
+
+#ifdef SEARCH_TRACE
+    static constexpr bool ENABLED = true;
+
+private:
+    typedef chrono::steady_clock Clock;
+    static const size_t MAX_SAMPLES = 256;
+
+    Clock::time_point start;
+    double totalSeconds = 0;
+    double phaseSeconds[PHASES] = {};
+    long long expansions = 0;
+    long long sampleInterval = 1;
+    vector<array<double, 3>> openSamples;
+    vector<long long> fHistogram;
+    map<int, long long> errorHistogram;
+    long long duplicateChecks = 0;
+    long long duplicateHits = 0;
+    size_t peakBytes = 0;
+
+public:
+    class Timer
+    {
+    private:
+        double &seconds;
+        Clock::time_point start = Clock::now();
+
+    public:
+        Timer(double &seconds) : seconds(seconds) {}
+        ~Timer()
+        {
+            seconds += chrono::duration<double>(Clock::now() - start).count();
+        }
+    };
+
+    void reset()
+    {
+        *this = SearchTrace();
+        start = Clock::now();
+    }
+    Timer time(Phase phase)
+    {
+        return Timer(phaseSeconds[phase]);
+    }
+    void duplicate(bool hit)
+    {
+        duplicateChecks++;
+        duplicateHits += hit;
+    }
+    // openSize is sampled at most MAX_SAMPLES times; when the buffer fills up
+    // every other sample is dropped and the interval doubles.
+    void expand(float f, size_t openSize, size_t bytes)
+    {
+        int bucket = max(0, (int)f);
+        if (bucket >= (int)fHistogram.size())
+            fHistogram.resize(bucket + 1);
+        fHistogram[bucket]++;
+        if (expansions++ % sampleInterval != 0)
+            return;
+        peakBytes = max(peakBytes, bytes);
+        if (openSamples.size() == MAX_SAMPLES)
+        {
+            for (size_t i = 0; i < MAX_SAMPLES / 2; i++)
+                openSamples[i] = openSamples[2 * i];
+            openSamples.resize(MAX_SAMPLES / 2);
+            sampleInterval *= 2;
+            if ((expansions - 1) % sampleInterval != 0)
+                return;
+        }
+        openSamples.push_back({(double)expansions, (double)openSize, chrono::duration<double>(Clock::now() - start).count()});
+    }
+    // error is the true distance to the goal minus the heuristic value.
+    void heuristicError(float error)
+    {
+        errorHistogram[(int)floor(error)]++;
+    }
+    void finish(size_t bytes)
+    {
+        peakBytes = max(peakBytes, bytes);
+        totalSeconds = chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    string json() const
+    {
+        static const char *phaseNames[PHASES] = {"heuristic", "duplicate_check", "queue", "path"};
+        ostringstream out;
+        double other = totalSeconds;
+        out << "{\"seconds\":" << totalSeconds << ",\"phases\":{";
+        for (int phase = 0; phase < PHASES; phase++)
+        {
+            out << "\"" << phaseNames[phase] << "\":" << phaseSeconds[phase] << ",";
+            other -= phaseSeconds[phase];
+        }
+        out << "\"other\":" << max(0.0, other) << "},\"open_size\":[";
+        for (size_t i = 0; i < openSamples.size(); i++)
+        {
+            out << (i ? "," : "") << "[" << (long long)openSamples[i][0] << "," << (long long)openSamples[i][1] << "," << openSamples[i][2] << "]";
+        }
+        out << "],\"f_histogram\":{";
+        bool first = true;
+        for (size_t f = 0; f < fHistogram.size(); f++)
+        {
+            if (fHistogram[f] == 0)
+                continue;
+            out << (first ? "" : ",") << "\"" << f << "\":" << fHistogram[f];
+            first = false;
+        }
+        out << "},\"heuristic_error\":{";
+        first = true;
+        for (auto [error, count] : errorHistogram)
+        {
+            out << (first ? "" : ",") << "\"" << error << "\":" << count;
+            first = false;
+        }
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        out << "},\"duplicate_checks\":" << duplicateChecks << ",\"duplicate_hits\":" << duplicateHits
+            << ",\"duplicate_hit_rate\":" << (duplicateChecks ? (double)duplicateHits / duplicateChecks : 0.0)
+            << ",\"peak_search_bytes\":" << peakBytes << ",\"peak_rss_kb\":" << usage.ru_maxrss << "}";
+        return out.str();
+    }
+#else
+    static constexpr bool ENABLED = false;
+
+    class Timer
+    {
+    public:
+        ~Timer() {}
+    };
+
+    void reset() {}
+    Timer time(Phase) { return Timer(); }
+    void duplicate(bool) {}
+    void expand(float, size_t, size_t) {}
+    void heuristicError(float) {}
+    void finish(size_t) {}
+    string json() const { return ""; }
+#endif
+};
@@ -0,0 +1,232 @@
+import argparse
+import csv
+import os
+import random
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+
+# Benchmark driver for the N-puzzle solver. Builds a release binary, runs every
+# (instance set, heuristic, engine) combination one puzzle per process, and
+# writes one CSV row per run so results of two builds can be diffed/compared.
+#
+#   python3 benchmark.py                                  # default suites
+#   python3 benchmark.py --korf korf100.txt --build-pdb   # + Korf's 15-puzzles
+#   python3 benchmark.py --baseline old.csv               # report regressions
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+BINARY = os.path.join(HERE, '2105109_release')
+HEURISTICS = ['Hamming', 'Manhatten', 'Euclidean', 'Linear', 'Walking', 'WalkingLinear', 'PDB']
+ENGINES = ['AStar', 'IDAStar', 'Bidirectional', 'HDAStar', 'WeightedAStar', 'Beam', 'External', 'ExternalBFS']
+# Engines that return the best solution found once their --time budget runs out.
+ANYTIME_ENGINES = ['WeightedAStar', 'Beam']
+# Engines that spill their frontier to files, kept in the run's scratch directory.
+EXTERNAL_ENGINES = ['External', 'ExternalBFS']
+COLUMNS = ['suite', 'puzzle', 'k', 'heuristic', 'engine', 'status', 'moves', 'explored', 'expanded',
+           'seconds', 'expanded_per_second', 'wall_seconds', 'peak_rss_kb']
+
+
+def build():
+    command = ['g++', '-O3', '-march=native', '-DNDEBUG', '-pthread', '2105109.cpp', '-o', BINARY]
+    print(' '.join(command), file=sys.stderr)
+    subprocess.run(command, cwd=HERE, check=True)
+
+
+def is_solvable(tiles, k):
+    values = [t for t in tiles if t != 0]
+    inversions = sum(1 for i in range(len(values)) for j in range(i + 1, len(values)) if values[i] > values[j])
+    if k % 2 == 1:
+        return inversions % 2 == 0
+    blank_row = tiles.index(0) // k
+    return (blank_row + inversions) % 2 == 1
+
+
+def random_solvable(k, rng):
+    tiles = list(range(k * k))
+    while True:
+        rng.shuffle(tiles)
+        if is_solvable(tiles, k):
+            return list(tiles)
+
+
+# Random walk of the blank from the goal, never undoing the previous move.
+def random_walk(k, steps, rng):
+    tiles = list(range(1, k * k)) + [0]
+    blank, previous = k * k - 1, -1
+    for _ in range(steps):
+        x, y = divmod(blank, k)
+        cells = [nx * k + ny for nx, ny in ((x - 1, y), (x + 1, y), (x, y - 1), (x, y + 1))
+                 if 0 <= nx < k and 0 <= ny < k and nx * k + ny != previous]
+        cell = rng.choice(cells)
+        tiles[blank], tiles[cell] = tiles[cell], 0
+        previous, blank = blank, cell
+    return tiles
+
+
+# Korf's instances use the goal 0 1 2 ... (blank first). Rotating the board by
+# 180 degrees and relabelling tile t as k*k - t maps that goal onto this
+# solver's goal (blank last) and keeps every solution length.
+def from_korf(values, k):
+    n = k * k
+    tiles = [0] * n
+    for cell, tile in enumerate(values):
+        tiles[n - 1 - cell] = 0 if tile == 0 else n - tile
+    return tiles
+
+
+# One instance per line: k*k tiles, optionally preceded by an index.
+def read_instances(path, k, korf):
+    instances = []
+    with open(path) as file:
+        for line in file:
+            values = [int(v) for v in line.split()]
+            if len(values) not in (k * k, k * k + 1):
+                continue
+            values = values[-k * k:]
+            instances.append(from_korf(values, k) if korf else values)
+    return instances
+
+
+def make_suites(args):
+    rng = random.Random(args.seed)
+    suites = [('random-3x3', 3, [random_solvable(3, rng) for _ in range(args.count_3x3)]),
+              ('walk-4x4', 4, [random_walk(4, args.walk_4x4, rng) for _ in range(args.count_4x4)]),
+              ('walk-5x5', 5, [random_walk(5, args.walk_5x5, rng) for _ in range(args.count_5x5)])]
+    if args.korf:
+        suites.append(('korf-15', 4, read_instances(args.korf, 4, True)))
+    if args.korf24:
+        suites.append(('korf-24', 5, read_instances(args.korf24, 5, True)))
+    return [suite for suite in suites if suite[2]]
+
+
+def limit_memory(megabytes):
+    def apply():
+        limit = megabytes * 1024 * 1024
+        resource.setrlimit(resource.RLIMIT_AS, (limit, limit))
+    return apply
+
+
+def run_one(args, scratch, k, tiles, heuristic, engine):
+    puzzle_path = os.path.join(scratch, 'puzzle.txt')
+    result_path = os.path.join(scratch, 'result.csv')
+    with open(puzzle_path, 'w') as file:
+        file.write(f'{k}\n')
+        for row in range(k):
+            file.write(' '.join(str(t) for t in tiles[row * k:(row + 1) * k]) + '\n')
+    if os.path.exists(result_path):
+        os.remove(result_path)
+
+    command = [BINARY, heuristic, engine, '--batch', puzzle_path, result_path, '--threads', str(args.threads)]
+    if engine in ANYTIME_ENGINES:
+        command += ['--time', str(args.anytime_seconds)]
+    if engine in EXTERNAL_ENGINES:
+        command += ['--temp-dir', os.path.join(scratch, 'frontier')]
+    start = time.monotonic()
+    process = subprocess.Popen(command, cwd=HERE, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                               preexec_fn=limit_memory(args.memory_mb))
+    status = None
+    while True:
+        pid, code, usage = os.wait4(process.pid, os.WNOHANG)
+        if pid != 0:
+            break
+        if time.monotonic() - start > args.timeout:
+            process.kill()
+            pid, code, usage = os.wait4(process.pid, 0)
+            status = 'timeout'
+            break
+        time.sleep(0.01)
+    process.returncode = os.waitstatus_to_exitcode(code)
+    row = {'status': status or 'failed', 'wall_seconds': f'{time.monotonic() - start:.3f}',
+           'peak_rss_kb': usage.ru_maxrss}
+    if status is None and process.returncode == 0 and os.path.exists(result_path):
+        with open(result_path) as file:
+            result = next(csv.DictReader(file), None)
+        if result is not None:
+            expanded, seconds = int(result['expanded']), float(result['seconds'])
+            row.update(status=result['status'], moves=result['moves'], explored=result['explored'],
+                       expanded=expanded, seconds=result['seconds'],
+                       expanded_per_second=int(expanded / max(seconds, 1e-9)))
+    return row
+
+
+def compare(baseline_path, rows, tolerance):
+    def totals(source):
+        sums = {}
+        for row in source:
+            if row['status'] != 'solved':
+                continue
+            key = (row['suite'], row['heuristic'], row['engine'])
+            seconds, expanded = sums.get(key, (0.0, 0))
+            sums[key] = (seconds + float(row['seconds']), expanded + int(row['expanded']))
+        return sums
+
+    with open(baseline_path) as file:
+        before = totals(csv.DictReader(file))
+    after = totals(rows)
+    print(f'{"suite":<12} {"heuristic":<10} {"engine":<14} {"time ratio":>10} {"expanded ratio":>15}')
+    for key in sorted(after):
+        if key not in before:
+            continue
+        time_ratio = after[key][0] / max(before[key][0], 1e-9)
+        expanded_ratio = after[key][1] / max(before[key][1], 1)
+        flag = '  <-- slower' if time_ratio > 1 + tolerance else ''
+        print(f'{key[0]:<12} {key[1]:<10} {key[2]:<14} {time_ratio:>10.2f} {expanded_ratio:>15.2f}{flag}')
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Benchmark the N-puzzle solver.')
+    parser.add_argument('--output', default='benchmark.csv')
+    parser.add_argument('--heuristics', default=','.join(HEURISTICS))
+    parser.add_argument('--engines', default=','.join(ENGINES))
+    parser.add_argument('--seed', type=int, default=318)
+    parser.add_argument('--count-3x3', type=int, default=20)
+    parser.add_argument('--count-4x4', type=int, default=10)
+    parser.add_argument('--walk-4x4', type=int, default=60, help='random walk length of 4x4 instances')
+    parser.add_argument('--count-5x5', type=int, default=5)
+    parser.add_argument('--walk-5x5', type=int, default=40, help='random walk length of 5x5 instances')
+    parser.add_argument('--korf', help="Korf's 100 15-puzzle instances, one per line")
+    parser.add_argument('--korf24', help='24-puzzle instances in the same format')
+    parser.add_argument('--build-pdb', action='store_true', help='build missing 3x3/4x4 pattern databases')
+    parser.add_argument('--threads', type=int, default=1, help='threads per solve (HDA*)')
+    parser.add_argument('--timeout', type=float, default=60, help='seconds per solve')
+    parser.add_argument('--anytime-seconds', type=float, default=10,
+                        help='time budget of WeightedAStar and Beam, below --timeout')
+    parser.add_argument('--memory-mb', type=int, default=2048, help='address space limit per solve')
+    parser.add_argument('--baseline', help='earlier benchmark CSV to compare against')
+    parser.add_argument('--tolerance', type=float, default=0.1, help='slowdown flagged by --baseline')
+    parser.add_argument('--no-build', action='store_true')
+    args = parser.parse_args()
+
+    if not args.no_build:
+        build()
+    suites = make_suites(args)
+    heuristics = args.heuristics.split(',')
+    if 'PDB' in heuristics and args.build_pdb:
+        for k in sorted({k for _, k, _ in suites if k <= 4}):
+            if not os.path.exists(os.path.join(HERE, f'pdb_{k}.bin')):
+                subprocess.run([BINARY, 'BuildPDB', str(k)], cwd=HERE, check=True)
+
+    rows = []
+    with open(args.output, 'w', newline='') as file, tempfile.TemporaryDirectory() as scratch:
+        writer = csv.DictWriter(file, fieldnames=COLUMNS)
+        writer.writeheader()
+        for suite, k, instances in suites:
+            for heuristic in heuristics:
+                for engine in args.engines.split(','):
+                    for index, tiles in enumerate(instances):
+                        row = {'suite': suite, 'puzzle': index + 1, 'k': k, 'heuristic': heuristic, 'engine': engine}
+                        if heuristic == 'PDB' and not os.path.exists(os.path.join(HERE, f'pdb_{k}.bin')):
+                            row['status'] = 'skipped'
+                        elif heuristic.startswith('Walking') and k > 4:
+                            row['status'] = 'skipped'
+                        else:
+                            row.update(run_one(args, scratch, k, tiles, heuristic, engine))
+                        writer.writerow(row)
+                        file.flush()
+                        rows.append({key: str(value) for key, value in row.items()})
+                    print(f'{suite} {heuristic} {engine}: done', file=sys.stderr)
+
+    if args.baseline:
+        compare(args.baseline, rows, args.tolerance)
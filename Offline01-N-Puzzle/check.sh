@@ -1,5 +1,22 @@
-g++ -fsanitize=address -g 2105109.cpp -o 2105109
+g++ -fsanitize=address -g -DDEBUG_HEURISTICS 2105109.cpp -o 2105109
 ./2105109  Hamming
 ./2105109  Linear
 ./2105109  Manhatten
-./2105109  Euclidean
\ No newline at end of file
+./2105109  Euclidean
+./2105109  Manhatten IDAStar
+./2105109  Linear IDAStar
+./2105109  BuildPDB 3
+./2105109  PDB
+./2105109  PDB IDAStar
+./2105109  PDB AStar --batch pdb_input.txt pdb_results.csv
+./2105109  Manhatten AStar --batch pdb_input.txt results.csv
+diff <(cut -d, -f1-4 pdb_results.csv) <(cut -d, -f1-4 results.csv)
+./2105109  Linear AStar --batch input.txt results.csv
+./2105109  Manhatten IDAStar --batch mixed_input.txt results.csv --threads 2
+./2105109  Linear HDAStar --threads 4
+./2105109  Linear Bidirectional
+./2105109  Linear WeightedAStar --weight 3 --time 5
+./2105109  Linear Beam --beam 1000 --time 5
+./2105109  WalkingLinear
+./2105109  Linear External --buffer-mb 64
+echo "1 Linear AStar 3 1 2 3 4 5 6 0 7 8" | ./2105109  Serve --threads 2
@@ -1,149 +1,40 @@
-#include <bits/stdc++.h>
+#include "2105109_Graph.h"
+#include "2105109_GraphIO.h"
+#include "2105109_LocalSearch.h"
+#include <glob.h>
 
 using namespace std;
-struct pair_hash
+// Runs the trials 64 at a time: bit t of side[v] is the side of v in trial t,
+// so an edge is cut in popcount(side[u] ^ side[v]) of the trials and one pass
+// over the edges scores all of them: O(m * n / 64) for n trials instead of
+// O(|V|^2) hash lookups per trial.
+double RandomizedMaxCut(Graph &graph, int n, mt19937_64 &rng)
 {
-    template <typename T1, typename T2>
-    size_t operator()(const pair<T1, T2> &p) const
-    {
-        return hash<T1>()(p.first) ^ (hash<T2>()(p.second) << 1);
-    }
-};
-class Edge
-{
-public:
-    int u, v, w;
-    Edge(int u, int v, int w)
-    {
-        this->u = u;
-        this->v = v;
-        this->w = w;
-    }
-};
-class Graph
-{
-private:
-    int numVertices;
-    int numEdges;
-    vector<Edge> edges;
-    vector<vector<pair<int, int>>> adj;
-    unordered_map<pair<int, int>, int, pair_hash> weights;
-
-public:
-    Graph(int n, int m)
-    {
-        numVertices = n;
-        numEdges = m;
-        adj.resize(n);
-    }
-
-    void addEdge(int u, int v, int w)
-    {
-        u--;
-        v--;
-        weights[{u, v}] = w;
-        weights[{v, u}] = w;
-        edges.push_back(Edge(u, v, w));
-        adj[u].push_back({v, w});
-        adj[v].push_back({u, w});
-    }
-
-    int getNumVertices()
-    {
-        return numVertices;
-    }
-    const vector<Edge> &getEdges()
-    {
-        return edges;
-    }
-    const vector<vector<pair<int, int>>> &getAdj()
-    {
-        return adj;
-    }
-
-    int getNumEdges()
-    {
-        return numEdges;
-    }
-
-    int getWeight(int u, int v)
-    {
-        if (weights.find({u, v}) != weights.end())
-        {
-            return weights.at({u, v});
-        }
-        return 0;
-    }
-    pair<int, int> getMaxmiumEdge()
-    {
-        int maxWeight = -1;
-        pair<int, int> maxEdge = {-1, -1};
-        for (const auto &edge : edges)
-        {
-            if (edge.w > maxWeight)
-            {
-                maxWeight = edge.w;
-                maxEdge = {edge.u, edge.v};
-            }
-        }
-        return maxEdge;
-    }
-    pair<int, int> findMaxWeightEdge()
-    {
-        int maxWeight = -1;
-        pair<int, int> maxEdge = {-1, -1};
-        for (const auto &edge : weights)
-        {
-            if (edge.second > maxWeight)
-            {
-                maxWeight = edge.second;
-                maxEdge = edge.first;
-            }
-        }
-        return maxEdge;
-    }
-};
-double randomProbability()
-{
-    static mt19937 rng(chrono::steady_clock::now().time_since_epoch().count());
-    return static_cast<double>(rng()) / rng.max();
-}
-double RandomizedMaxCut(Graph &graph, int n)
-{
-    int totalCutWeight = 0;
-    const auto &edges = graph.getEdges();
-    for (int i = 1; i <= n; i++)
+    long long totalCutWeight = 0;
+    int node = graph.getNumVertices();
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
+    vector<uint64_t> side(node);
+    for (int first = 0; first < n; first += 64)
     {
-        unordered_set<int> X;
-        unordered_set<int> Y;
-        int node = graph.getNumVertices();
+        int trials = min(64, n - first);
+        uint64_t mask = trials == 64 ? ~0ULL : (1ULL << trials) - 1;
         for (int j = 0; j < node; j++)
         {
-            if (randomProbability() >= 0.5)
-            {
-                X.insert(j);
-            }
-            else
-            {
-                Y.insert(j);
-            }
+            side[j] = rng() & mask;
         }
-        int cutWeight = 0;
         for (int j = 0; j < node; j++)
         {
-            for (int k = j + 1; k < node; k++)
+            for (int i = offsets[j]; i < offsets[j + 1]; i++)
             {
-                if (X.count(j) && Y.count(k))
-                {
-                    cutWeight += graph.getWeight(j, k);
-                }
-                else if (Y.count(j) && X.count(k))
+                int k = neighbours[i];
+                if (j < k)
                 {
-                    cutWeight += graph.getWeight(j, k);
+                    totalCutWeight += (long long)weights[i] * __builtin_popcountll(side[j] ^ side[k]);
                 }
             }
         }
-        totalCutWeight += cutWeight;
     }
     double averageCutWeight = totalCutWeight / n;
     return averageCutWeight;
@@ -153,6 +44,9 @@ pair<unordered_set<int>, unordered_set<int>> GreedyMaxCut(Graph &graph)
     unordered_set<int> X;
     unordered_set<int> Y;
     int node = graph.getNumVertices();
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
     pair<int, int> maxEdge = graph.findMaxWeightEdge();
     X.insert(maxEdge.first);
     Y.insert(maxEdge.second);
@@ -164,15 +58,16 @@ pair<unordered_set<int>, unordered_set<int>> GreedyMaxCut(Graph &graph)
         }
         int weightX = 0;
         int weightY = 0;
-        for (int j = 0; j < node; j++)
+        for (int k = offsets[i]; k < offsets[i + 1]; k++)
         {
+            int j = neighbours[k];
             if (X.count(j))
             {
-                weightX += graph.getWeight(i, j);
+                weightX += weights[k];
             }
             else if (Y.count(j))
             {
-                weightY += graph.getWeight(i, j);
+                weightY += weights[k];
             }
         }
         if (weightX > weightY)
@@ -187,102 +82,174 @@ pair<unordered_set<int>, unordered_set<int>> GreedyMaxCut(Graph &graph)
     return {X, Y};
 }
 
-pair<int,vector<int>> semiGreedyMaxCut(Graph &graph, double alpha)
+// How many of a multiset of values in [-range, range] lie below a bound, and
+// its k-th smallest value, each in O(log range) (a Fenwick tree of counts).
+class ValueCounts
 {
-    int noOfVertices = graph.getNumVertices();
-    const auto &adj = graph.getAdj();
-    vector<int> partitionSet(noOfVertices, -1);
-
-    const auto &edges = graph.getEdges();
-    int maxWeight = -1, startU = -1, startV = -1;
-    const auto &maxEdge = graph.getMaxmiumEdge();
-    startU = maxEdge.first;
-    startV = maxEdge.second;
-    partitionSet[startU] = 0;
-    partitionSet[startV] = 1;
+private:
+    int range;
+    int size = 1;
+    vector<int> tree;
 
-    set<int> unassignedVertex;
-    for (int i = 0; i < noOfVertices; i++)
+public:
+    ValueCounts(int range) : range(range)
     {
-        if (partitionSet[i] == -1)
-            unassignedVertex.insert(i);
+        while (size < 2 * range + 1)
+            size <<= 1;
+        tree.assign(size + 1, 0);
     }
 
-    while (!unassignedVertex.empty())
+    void add(int value, int count)
     {
-        vector<pair<int, int>> scores;
-
-        int wmin = INT_MAX, wmax = INT_MIN;
-        for (int v : unassignedVertex)
+        for (int i = value + range + 1; i <= size; i += i & -i)
         {
-            int sigmaA = 0, sigmaB = 0;
-            for (const auto &p : adj[v])
+            tree[i] += count;
+        }
+    }
+    int countBelow(int value) const
+    {
+        int count = 0;
+        for (int i = min(max(value + range, 0), size); i > 0; i -= i & -i)
+        {
+            count += tree[i];
+        }
+        return count;
+    }
+    // The k-th smallest value, counting from 0.
+    int kth(int k) const
+    {
+        int position = 0;
+        for (int step = size; step > 0; step >>= 1)
+        {
+            if (position + step <= size && tree[position + step] <= k)
             {
-                int vertex = p.first;
-                int w = p.second;
-                if (partitionSet[vertex] == 0)
-                    sigmaA += w;
-                else if (partitionSet[vertex] == 1)
-                    sigmaB += w;
+                position += step;
+                k -= tree[position];
             }
-            int greedyVal = max(sigmaA, sigmaB);
-            scores.emplace_back(greedyVal, v);
-            wmin = min(wmin, min(sigmaA, sigmaB));
-            wmax = max(wmax, greedyVal);
         }
+        return position - range;
+    }
+};
 
-        int mu = wmin + alpha * (wmax - wmin);
-        vector<int> RCL;
-        for (const auto &p : scores)
+// sigmaA[v] / sigmaB[v] is the weight from v to the vertices already placed
+// on side 0 / 1. Placing a vertex only changes the sigmas of its neighbours,
+// so they are updated there instead of being recomputed for every candidate.
+// The unassigned vertices are bucketed by their greedy value max(sigmaA,
+// sigmaB), with ValueCounts over those values and over min(sigmaA, sigmaB):
+// wmin, wmax, the size of the RCL and a uniform pick from it all take
+// O(log W) for W the largest total |weight| at a vertex, so a construction
+// costs O((n + m) log W).
+pair<int,vector<int>> semiGreedyMaxCut(Graph &graph, double alpha, mt19937 &rng)
+{
+    int noOfVertices = graph.getNumVertices();
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
+    vector<int> partitionSet(noOfVertices, -1);
+    vector<int> sigmaA(noOfVertices, 0), sigmaB(noOfVertices, 0);
+
+    int range = 0;
+    for (int v = 0; v < noOfVertices; v++)
+    {
+        int total = 0;
+        for (int i = offsets[v]; i < offsets[v + 1]; i++)
         {
-            int val = p.first;
-            int v = p.second;
-            if (val >= mu)
-                RCL.push_back(v);
+            total += abs(weights[i]);
         }
+        range = max(range, total);
+    }
+    ValueCounts lowCounts(range), highCounts(range);
+    vector<vector<int>> byHigh(2 * range + 1);
+    vector<int> position(noOfVertices);
+    auto insert = [&](int v)
+    {
+        int high = max(sigmaA[v], sigmaB[v]);
+        vector<int> &bucket = byHigh[high + range];
+        position[v] = bucket.size();
+        bucket.push_back(v);
+        highCounts.add(high, 1);
+        lowCounts.add(min(sigmaA[v], sigmaB[v]), 1);
+    };
+    auto remove = [&](int v)
+    {
+        int high = max(sigmaA[v], sigmaB[v]);
+        vector<int> &bucket = byHigh[high + range];
+        int last = bucket.back();
+        bucket[position[v]] = last;
+        position[last] = position[v];
+        bucket.pop_back();
+        highCounts.add(high, -1);
+        lowCounts.add(min(sigmaA[v], sigmaB[v]), -1);
+    };
+    for (int v = 0; v < noOfVertices; v++)
+    {
+        insert(v);
+    }
 
-        if (RCL.empty())
-            RCL.push_back(scores[0].second);
-
-        int chosen = RCL[rand() % RCL.size()];
-
-        int scoreA = 0, scoreB = 0;
-        for (const auto &p : adj[chosen])
+    int unassigned = noOfVertices;
+    auto assign = [&](int v, int side)
+    {
+        remove(v);
+        unassigned--;
+        partitionSet[v] = side;
+        vector<int> &sigma = side == 0 ? sigmaA : sigmaB;
+        for (int i = offsets[v]; i < offsets[v + 1]; i++)
         {
-            int nei = p.first;
-            int w = p.second;
-            if (partitionSet[nei] == 0)
-                scoreA += w;
-            else if (partitionSet[nei] == 1)
-                scoreB += w;
+            int u = neighbours[i];
+            if (partitionSet[u] != -1)
+                continue;
+            remove(u);
+            sigma[u] += weights[i];
+            insert(u);
         }
-        partitionSet[chosen] = (scoreA > scoreB) ? 1 : 0;
-        unassignedVertex.erase(chosen);
-    }
+    };
 
-    int cutWeight = 0;
-    for (const auto &e : edges)
+    const auto &maxEdge = graph.getMaxmiumEdge();
+    assign(maxEdge.first, 0);
+    assign(maxEdge.second, 1);
+
+    while (unassigned > 0)
     {
-        if (partitionSet[e.u] != partitionSet[e.v])
-            cutWeight += e.w;
+        int wmin = lowCounts.kth(0);
+        int wmax = highCounts.kth(unassigned - 1);
+        int mu = wmin + alpha * (wmax - wmin);
+        // The RCL is every vertex whose greedy value is at least mu: ranks
+        // [below, unassigned) of the values in highCounts.
+        int below = highCounts.countBelow(mu);
+        if (below == unassigned)
+            below = 0;
+        int rank = below + rng() % (unassigned - below);
+        int high = highCounts.kth(rank);
+        int chosen = byHigh[high + range][rank - highCounts.countBelow(high)];
+        assign(chosen, (sigmaA[chosen] > sigmaB[chosen]) ? 1 : 0);
     }
+
+    int cutWeight = calculateCutWeight(graph, partitionSet);
     return {cutWeight,partitionSet};
 }
 int calculateCutWeight(Graph &graph, unordered_set<int> &X, unordered_set<int> &Y)
 {
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
     int cutWeight = 0;
     for (auto x : X)
     {
-        for (auto y : Y)
+        for (int i = offsets[x]; i < offsets[x + 1]; i++)
         {
-            cutWeight += graph.getWeight(x, y);
+            if (Y.count(neighbours[i]))
+                cutWeight += weights[i];
         }
     }
     return cutWeight;
 }
-pair<int, int> LocalSearch(Graph &graph, vector<int> &partitionSet)
+pair<int, int> LocalSearch(Graph &graph, vector<int> &partitionSet, LocalSearchStats *stats = nullptr)
 {
-    const auto &adj = graph.getAdj();
+    auto start = chrono::steady_clock::now();
+    long long flips = 0;
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
     int noOfVertices = graph.getNumVertices();
     bool isImproved;
     int iterationCount = 0;
@@ -293,9 +260,9 @@ pair<int, int> LocalSearch(Graph &graph, vector<int> &partitionSet)
         for (int v = 0; v < noOfVertices; ++v)
         {
             int gain = 0;
-            for (const auto &p : adj[v])
+            for (int i = offsets[v]; i < offsets[v + 1]; i++)
             {
-                int vertex = p.first, w = p.second;
+                int vertex = neighbours[i], w = weights[i];
                 if (partitionSet[v] == partitionSet[vertex])
                     gain += w;
                 else
@@ -305,75 +272,629 @@ pair<int, int> LocalSearch(Graph &graph, vector<int> &partitionSet)
             {
                 partitionSet[v] ^= 1;
                 isImproved = true;
+                flips++;
             }
         }
         if (isImproved)
             iterationCount++;
     } while (isImproved);
 
-    int cutWeight = 0;
-    const auto &edges = graph.getEdges();
-    for (const auto &e : edges)
+    int cutWeight = calculateCutWeight(graph, partitionSet);
+    if (stats != nullptr)
     {
-        if (partitionSet[e.u] != partitionSet[e.v])
-            cutWeight += e.w;
+        stats->iterationCount += iterationCount;
+        stats->flips += flips;
+        stats->seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
     }
 
     return {cutWeight, iterationCount};
 }
-pair<int, int> graspMaxCut(Graph &graph, double alpha, int iterations)
+// Improvement step applied to every GRASP construction. Inside GRASP, tabu
+// search stops after n moves without a new best and ILS after 20 fruitless
+// perturbations, so the runs do not depend on the clock.
+enum class ImprovementStep
+{
+    LOCAL,
+    TABU,
+    ILS
+};
+const double ILS_STRENGTH = 0.02;
+
+pair<int, int> improve(Graph &graph, vector<int> &partitionSet, ImprovementStep step, mt19937 &rng)
+{
+    SearchBudget budget;
+    if (step == ImprovementStep::TABU)
+    {
+        budget.maxStall = graph.getNumVertices();
+        return TabuSearch(graph, partitionSet, rng, budget);
+    }
+    if (step == ImprovementStep::ILS)
+    {
+        budget.maxStall = 20;
+        return IteratedLocalSearch(graph, partitionSet, rng, ILS_STRENGTH, budget);
+    }
+    return LocalSearch(graph, partitionSet);
+}
+// Iterations are handed out to the workers one at a time. Iteration i draws
+// from its own generator seeded with (seed, i), and ties between equal cuts go
+// to the lowest iteration, so the result depends on the seed only, never on
+// the number of threads or on which worker ran which iteration.
+pair<int, int> graspMaxCut(Graph &graph, double alpha, int iterations, unsigned seed, int threads = 1,
+                           ImprovementStep step = ImprovementStep::LOCAL)
 {
-    int bestCut = 0;
+    class WorkerBest
+    {
+    public:
+        int cut = 0;
+        int iteration = INT_MAX;
+        vector<int> partition;
+        long long localIterations = 0;
+    };
+    threads = max(1, min(threads, iterations));
+    vector<WorkerBest> best(threads);
+    atomic<int> next(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+                                 WorkerBest &mine = best[t];
+                                 for (int i = next++; i < iterations; i = next++)
+                                 {
+                                     seed_seq sequence{seed, (unsigned)i};
+                                     mt19937 rng(sequence);
+                                     auto [_, partitionSet] = semiGreedyMaxCut(graph, alpha, rng);
+                                     auto [cutWeight, localIterations] = improve(graph, partitionSet, step, rng);
+                                     mine.localIterations += localIterations;
+                                     if (cutWeight > mine.cut)
+                                     {
+                                         mine.cut = cutWeight;
+                                         mine.iteration = i;
+                                         mine.partition = partitionSet;
+                                     }
+                                 }
+                             });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    int bestCut = 0, bestIteration = INT_MAX;
     vector<int> bestPartition;
-    int totalLocalIterations = 0;
-    for (int i = 0; i < iterations; i++)
+    long long totalLocalIterations = 0;
+    for (auto &mine : best)
     {
-        auto [_, partitionSet] = semiGreedyMaxCut(graph, alpha);
-        pair<int, int> localResult = LocalSearch(graph, partitionSet);
-        int cutWeight = localResult.first;
-        int localIterations = localResult.second;
-        totalLocalIterations += localIterations;
-        if (cutWeight > bestCut)
+        totalLocalIterations += mine.localIterations;
+        if (mine.cut > bestCut || (mine.cut == bestCut && mine.iteration < bestIteration))
         {
-            bestCut = cutWeight;
-            bestPartition = partitionSet;
+            bestCut = mine.cut;
+            bestIteration = mine.iteration;
+            bestPartition = std::move(mine.partition);
         }
     }
     totalLocalIterations /= iterations;
-    return {bestCut, totalLocalIterations};
+    return {bestCut, (int)totalLocalIterations};
 }
-Graph readGraph(const string &filename)
+// Solutions kept for path relinking: the best cuts seen, each at least
+// minDistance flips away from every other one. A partition and its complement
+// are the same cut, so distances are taken up to complement.
+class ElitePool
 {
-    ifstream file(filename);
-    if (!file.is_open())
+public:
+    vector<pair<int, vector<int>>> solutions;
+    size_t capacity;
+    int minDistance;
+
+    ElitePool(size_t capacity, int minDistance) : capacity(capacity), minDistance(minDistance) {}
+
+    static int distance(const vector<int> &a, const vector<int> &b)
     {
-        cerr << "Error: Could not open file " << filename << endl;
-        exit(1);
+        int differ = 0;
+        for (size_t v = 0; v < a.size(); v++)
+        {
+            differ += a[v] != b[v];
+        }
+        return min<int>(differ, a.size() - differ);
     }
 
-    int n, m;
-    file >> n >> m;
-    Graph graph(n, m);
+    // A new best always gets in unless it is already in the pool; anything
+    // else has to be diverse and, once the pool is full, beat the worst.
+    void offer(int cut, const vector<int> &partitionSet)
+    {
+        int closest = INT_MAX, best = INT_MIN;
+        size_t worst = 0;
+        for (size_t i = 0; i < solutions.size(); i++)
+        {
+            closest = min(closest, distance(solutions[i].second, partitionSet));
+            best = max(best, solutions[i].first);
+            if (solutions[i].first < solutions[worst].first)
+                worst = i;
+        }
+        if (closest == 0 || (closest < minDistance && cut <= best))
+            return;
+        if (solutions.size() < capacity)
+            solutions.push_back({cut, partitionSet});
+        else if (cut > solutions[worst].first)
+            solutions[worst] = {cut, partitionSet};
+    }
+};
 
-    for (int i = 0; i < m; i++)
+// Walks from `from` towards `guide`, each step flipping the differing vertex
+// with the highest gain, and returns the best partition strictly between the
+// two ends (or `from` if they are adjacent).
+pair<int, vector<int>> pathRelink(Graph &graph, const vector<int> &from, vector<int> guide)
+{
+    int n = graph.getNumVertices();
+    int differ = 0;
+    for (int v = 0; v < n; v++)
+    {
+        differ += from[v] != guide[v];
+    }
+    // Relink towards whichever of guide and its complement is closer.
+    if (differ > n - differ)
     {
-        int u, v, w;
-        file >> u >> v >> w;
-        graph.addEdge(u, v, w);
+        for (int v = 0; v < n; v++)
+        {
+            guide[v] ^= 1;
+        }
     }
-    cout << "Graph read successfully: " << filename << endl;
-    cout << "Number of vertices: " << n << ", Number of edges: " << m << endl;
+    vector<int> current = from, best = from;
+    GainTable table(graph, current);
+    int bestCut = INT_MIN;
+    // The vertices still differing from guide, bucketed by gain.
+    GainBuckets differing(n, table.maxGain);
+    int remaining = 0;
+    for (int v = 0; v < n; v++)
+    {
+        if (current[v] != guide[v])
+        {
+            differing.insert(v, table.gain[v]);
+            remaining++;
+        }
+    }
+    while (remaining > 1)
+    {
+        int v = differing.best();
+        differing.remove(v, table.gain[v]);
+        remaining--;
+        table.flip(v, [&](int u, int oldGain)
+                   {
+                       if (current[u] != guide[u])
+                       {
+                           differing.remove(u, oldGain);
+                           differing.insert(u, table.gain[u]);
+                       }
+                   });
+        if (table.cutWeight > bestCut)
+        {
+            bestCut = table.cutWeight;
+            best = current;
+        }
+    }
+    if (bestCut == INT_MIN)
+        bestCut = table.cutWeight;
+    return {bestCut, best};
+}
+
+// Anytime GRASP: constructs and improves solutions until the time budget runs
+// out, relinking each one with a random elite solution and improving the
+// result with LocalSearch as well. Every new best cut is appended to
+// improvements together with the seconds elapsed when it was found.
+pair<int, vector<int>> graspTimed(Graph &graph, double alpha, double seconds, unsigned seed,
+                                  vector<pair<double, int>> &improvements, size_t eliteSize = 10)
+{
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&]()
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    mt19937 rng(seed);
+    ElitePool elite(eliteSize, max(1, graph.getNumVertices() / 100));
+    int bestCut = INT_MIN;
+    vector<int> bestPartition;
+    auto consider = [&](int cut, const vector<int> &partitionSet)
+    {
+        if (cut > bestCut)
+        {
+            bestCut = cut;
+            bestPartition = partitionSet;
+            improvements.push_back({elapsed(), cut});
+        }
+        elite.offer(cut, partitionSet);
+    };
+
+    // The budget is checked between phases, so it is overrun by at most one
+    // construction or local search; the first iteration always yields a cut.
+    do
+    {
+        auto [constructedCut, partitionSet] = semiGreedyMaxCut(graph, alpha, rng);
+        if (bestCut != INT_MIN && elapsed() >= seconds)
+        {
+            consider(constructedCut, partitionSet);
+            break;
+        }
+        consider(LocalSearch(graph, partitionSet).first, partitionSet);
+        if (elite.solutions.size() < 2 || elapsed() >= seconds)
+            continue;
+        const vector<int> &guide = elite.solutions[rng() % elite.solutions.size()].second;
+        auto [relinkCut, relinked] = pathRelink(graph, partitionSet, guide);
+        if (elapsed() >= seconds)
+        {
+            consider(relinkCut, relinked);
+            break;
+        }
+        consider(LocalSearch(graph, relinked).first, relinked);
+    } while (elapsed() < seconds);
+    return {bestCut, bestPartition};
+}
+// Best cuts reported in the literature for the G-set graphs; -1 if unknown.
+int knownBestCut(const string &graphName)
+{
+    static const unordered_map<string, int> knownBest = {
+        {"G1", 12078}, {"G22", 14123}, {"G43", 7027}, {"G2", 12084}, {"G3", 12077}, {"G14", 3187}, {"G15", 3169}, {"G16", 3172}, {"G11", 627}, {"G12", 621}, {"G13", 645}, {"G23", 14129}, {"G24", 14131}, {"G32", 1560}, {"G33", 1537}, {"G34", 1541}, {"G35", 8000}, {"G36", 7996}, {"G37", 8009}, {"G44", 7022}, {"G45", 7020}, {"G48", 6000}, {"G49", 6000}, {"G50", 5988}};
+    auto it = knownBest.find(graphName);
+    return it == knownBest.end() ? -1 : it->second;
+}
+// set1/g12.rud -> G12
+string graphNameOf(const string &filename)
+{
+    string graphName = filename.substr(filename.find_last_of('/') + 1);
+    graphName = graphName.substr(0, graphName.find('.'));
+    graphName[0] = toupper(graphName[0]);
+    return graphName;
+}
+// The ends of the heaviest edge on opposite sides, every other vertex on a
+// random side.
+vector<int> randomPartition(Graph &graph, mt19937 &rng)
+{
+    int n = graph.getNumVertices();
+    auto [su, sv] = graph.getMaxmiumEdge();
+    vector<int> partitionSet(n);
+    for (int v = 0; v < n; v++)
+    {
+        if (v != su && v != sv)
+            partitionSet[v] = rng() % 2;
+    }
+    partitionSet[su] = 0;
+    partitionSet[sv] = 1;
+    return partitionSet;
+}
+
+// Experiment sweep: every combination of graph, algorithm, alpha, iteration
+// count and seed in the spec is one job. Jobs run on a pool of workers, and
+// each finished job is appended to the results file as one CSV row with a
+// single write, so a crash loses at most the jobs in flight. Jobs whose row
+// is already in the file are skipped, so rerunning the same command resumes.
+//
+// Spec file, one "key = value" per line, lists separated by commas:
+//   graphs = set1/g*.rud          (glob; may be given more than once)
+//   algorithms = Randomized,Greedy,SemiGreedy,Local,LocalBest,LocalFirst,GRASP,GRASPPR,
+//                Tabu,ILS,GRASPTabu,GRASPILS
+//   alphas = 0.5,0.7              (SemiGreedy and GRASP)
+//   iterations = 30,50            (Randomized, the Local variants and GRASP)
+//   seconds = 1,10                (time budget of GRASPPR, GRASP with path relinking,
+//                                  and of Tabu and ILS from a random partition)
+//   seeds = 1,2,3
+//   threads = 4
+class SweepJob
+{
+public:
+    string graphFile;
+    string algorithm;
+    string alpha = "-";
+    string iterations = "-";
+    string seconds = "-";
+    string seed;
+
+    string key() const
+    {
+        return graphNameOf(graphFile) + "," + algorithm + "," + alpha + "," + iterations + "," + seconds + "," + seed;
+    }
+};
+
+const vector<string> SWEEP_ALGORITHMS = {"Randomized", "Greedy", "SemiGreedy", "Local", "LocalBest", "LocalFirst", "GRASP",
+                                         "GRASPPR", "Tabu", "ILS", "GRASPTabu", "GRASPILS"};
+
+// best_seconds is when the best cut was found; the whole run for algorithms
+// that are not anytime.
+const string SWEEP_HEADER = "graph,n,m,algorithm,alpha,iterations,seconds,seed,cut,local_iterations,known_best,best_seconds,wall_seconds";
+
+vector<string> splitList(const string &text)
+{
+    vector<string> items;
+    string item;
+    istringstream stream(text);
+    while (getline(stream, item, ','))
+    {
+        item.erase(0, item.find_first_not_of(" \t"));
+        item.erase(item.find_last_not_of(" \t") + 1);
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+// Runs one job; returns cut and local search iterations, and sets bestSeconds
+// for anytime algorithms.
+pair<double, long long> runSweepJob(Graph &graph, const SweepJob &job, double &bestSeconds)
+{
+    seed_seq jobSeed{(unsigned)stoul(job.seed)};
+    mt19937 rng(jobSeed);
+    int iterations = job.iterations == "-" ? 0 : stoi(job.iterations);
+    double alpha = job.alpha == "-" ? 0 : stod(job.alpha);
+    if (job.algorithm == "Randomized")
+    {
+        mt19937_64 bitRng(jobSeed);
+        return {RandomizedMaxCut(graph, iterations, bitRng), 0};
+    }
+    if (job.algorithm == "Greedy")
+    {
+        auto [X, Y] = GreedyMaxCut(graph);
+        return {calculateCutWeight(graph, X, Y), 0};
+    }
+    if (job.algorithm == "SemiGreedy")
+    {
+        return {semiGreedyMaxCut(graph, alpha, rng).first, 0};
+    }
+    if (job.algorithm == "GRASPPR")
+    {
+        vector<pair<double, int>> improvements;
+        int cut = graspTimed(graph, alpha, stod(job.seconds), rng(), improvements).first;
+        bestSeconds = improvements.back().first;
+        return {cut, 0};
+    }
+    if (job.algorithm == "Tabu" || job.algorithm == "ILS")
+    {
+        SearchBudget budget;
+        budget.seconds = stod(job.seconds);
+        vector<int> partitionSet = randomPartition(graph, rng);
+        LocalSearchStats stats;
+        auto [cut, moves] = job.algorithm == "Tabu" ? TabuSearch(graph, partitionSet, rng, budget, &stats)
+                                                    : IteratedLocalSearch(graph, partitionSet, rng, ILS_STRENGTH, budget, &stats);
+        bestSeconds = stats.bestSeconds;
+        return {cut, moves};
+    }
+    if (job.algorithm == "GRASP" || job.algorithm == "GRASPTabu" || job.algorithm == "GRASPILS")
+    {
+        ImprovementStep step = job.algorithm == "GRASPTabu" ? ImprovementStep::TABU
+                               : job.algorithm == "GRASPILS" ? ImprovementStep::ILS
+                                                             : ImprovementStep::LOCAL;
+        auto [cut, localIterations] = graspMaxCut(graph, alpha, iterations, rng(), 1, step);
+        return {cut, localIterations};
+    }
+    // Local variants: average over random starts, integer division as in the CSV.
+    long long cutSum = 0;
+    LocalSearchStats stats;
+    for (int i = 0; i < iterations; i++)
+    {
+        vector<int> partitionSet = randomPartition(graph, rng);
+        if (job.algorithm == "LocalBest")
+            cutSum += GainLocalSearch(graph, partitionSet, ImprovementPolicy::BEST, &stats).first;
+        else if (job.algorithm == "LocalFirst")
+            cutSum += GainLocalSearch(graph, partitionSet, ImprovementPolicy::FIRST, &stats).first;
+        else
+            cutSum += LocalSearch(graph, partitionSet, &stats).first;
+    }
+    return {(double)(cutSum / max(1, iterations)), stats.iterationCount / max(1, iterations)};
+}
+
+int runSweep(const string &specPath, const string &resultsPath)
+{
+    ifstream spec(specPath);
+    if (!spec.is_open())
+    {
+        cerr << "Error: Could not open " << specPath << endl;
+        return 1;
+    }
+    vector<string> graphFiles;
+    vector<string> algorithms = {"Randomized", "Greedy", "SemiGreedy", "Local", "GRASP"};
+    vector<string> alphas = {"0.7"}, iterationCounts = {"50"}, budgets = {"10"}, seeds = {"1"};
+    int threads = max(1u, thread::hardware_concurrency());
+    string line;
+    while (getline(spec, line))
+    {
+        line = line.substr(0, line.find('#'));
+        size_t equals = line.find('=');
+        if (equals == string::npos)
+            continue;
+        string key = splitList(line.substr(0, equals)).at(0);
+        vector<string> values = splitList(line.substr(equals + 1));
+        if (key == "graphs")
+        {
+            for (const auto &pattern : values)
+            {
+                glob_t matches;
+                if (glob(pattern.c_str(), 0, nullptr, &matches) == 0)
+                    graphFiles.insert(graphFiles.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+                globfree(&matches);
+            }
+        }
+        else if (key == "algorithms")
+        {
+            for (const auto &algorithm : values)
+            {
+                if (find(SWEEP_ALGORITHMS.begin(), SWEEP_ALGORITHMS.end(), algorithm) == SWEEP_ALGORITHMS.end())
+                {
+                    cerr << "Error: Unknown algorithm " << algorithm << " in " << specPath << endl;
+                    return 1;
+                }
+            }
+            algorithms = values;
+        }
+        else if (key == "alphas")
+            alphas = values;
+        else if (key == "iterations")
+            iterationCounts = values;
+        else if (key == "seconds")
+            budgets = values;
+        else if (key == "seeds")
+            seeds = values;
+        else if (key == "threads")
+            threads = max(1, stoi(values.at(0)));
+        else
+        {
+            cerr << "Error: Unknown key " << key << " in " << specPath << endl;
+            return 1;
+        }
+    }
+
+    vector<SweepJob> jobs;
+    for (const auto &graphFile : graphFiles)
+        for (const auto &algorithm : algorithms)
+        {
+            bool usesSeconds = algorithm == "GRASPPR" || algorithm == "Tabu" || algorithm == "ILS";
+            bool usesAlpha = algorithm == "SemiGreedy" || algorithm.substr(0, 5) == "GRASP";
+            bool usesIterations = algorithm != "Greedy" && algorithm != "SemiGreedy" && !usesSeconds;
+            for (const auto &alpha : usesAlpha ? alphas : vector<string>{"-"})
+                for (const auto &iterations : usesIterations ? iterationCounts : vector<string>{"-"})
+                    for (const auto &seconds : usesSeconds ? budgets : vector<string>{"-"})
+                        for (const auto &seed : seeds)
+                            jobs.push_back({graphFile, algorithm, alpha, iterations, seconds, seed});
+        }
+
+    // A row cut short by a crash is dropped, so appends start on a fresh line.
+    set<string> completed;
+    bool hasHeader = false;
+    {
+        ifstream existing(resultsPath, ios::binary);
+        string contents((istreambuf_iterator<char>(existing)), istreambuf_iterator<char>());
+        size_t complete = contents.rfind('\n') == string::npos ? 0 : contents.rfind('\n') + 1;
+        if (complete < contents.size())
+            filesystem::resize_file(resultsPath, complete);
+        istringstream rows(contents.substr(0, complete));
+        while (getline(rows, line))
+        {
+            vector<string> fields;
+            istringstream row(line);
+            for (string field; getline(row, field, ',');)
+                fields.push_back(field);
+            if (line == SWEEP_HEADER)
+                hasHeader = true;
+            else if (fields.size() == 13)
+                completed.insert(fields[0] + "," + fields[3] + "," + fields[4] + "," + fields[5] + "," + fields[6] + "," + fields[7]);
+        }
+    }
+    int fd = open(resultsPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        cerr << "Error: Could not open " << resultsPath << endl;
+        return 1;
+    }
+    auto append = [fd](const string &row)
+    {
+        if (write(fd, row.data(), row.size()) != (ssize_t)row.size())
+            cerr << "Error: Short write to results" << endl;
+    };
+    if (!hasHeader)
+        append(SWEEP_HEADER + "\n");
+
+    vector<const SweepJob *> pending;
+    for (const auto &job : jobs)
+    {
+        if (!completed.count(job.key()))
+            pending.push_back(&job);
+    }
+    cerr << jobs.size() << " jobs, " << jobs.size() - pending.size() << " already done" << endl;
 
-    file.close();
-    return graph;
+    // Graphs are loaded once and shared by the jobs that use them.
+    mutex graphsLock;
+    map<string, shared_future<shared_ptr<Graph>>> graphs;
+    auto loadGraph = [&](const string &graphFile)
+    {
+        shared_future<shared_ptr<Graph>> graph;
+        promise<shared_ptr<Graph>> loading;
+        {
+            lock_guard<mutex> guard(graphsLock);
+            auto it = graphs.find(graphFile);
+            if (it == graphs.end())
+                it = graphs.emplace(graphFile, loading.get_future().share()).first;
+            else
+                return it->second.get();
+            graph = it->second;
+        }
+        loading.set_value(make_shared<Graph>(readGraph(graphFile)));
+        return graph.get();
+    };
+
+    atomic<size_t> next(0);
+    mutex logLock;
+    vector<thread> workers;
+    for (int t = 0; t < min<int>(threads, pending.size()); t++)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 for (size_t i = next++; i < pending.size(); i = next++)
+                                 {
+                                     const SweepJob &job = *pending[i];
+                                     shared_ptr<Graph> graph = loadGraph(job.graphFile);
+                                     auto start = chrono::steady_clock::now();
+                                     double bestSeconds = -1;
+                                     auto [cut, localIterations] = runSweepJob(*graph, job, bestSeconds);
+                                     double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                                     if (bestSeconds < 0)
+                                         bestSeconds = seconds;
+                                     string graphName = graphNameOf(job.graphFile);
+                                     ostringstream row;
+                                     row << graphName << "," << graph->getNumVertices() << "," << graph->getNumEdges() << ","
+                                         << job.algorithm << "," << job.alpha << "," << job.iterations << "," << job.seconds << "," << job.seed << ","
+                                         << cut << "," << localIterations << "," << knownBestCut(graphName) << "," << bestSeconds << "," << seconds << "\n";
+                                     append(row.str());
+                                     lock_guard<mutex> guard(logLock);
+                                     cerr << "[" << i + 1 << "/" << pending.size() << "] " << job.key() << " -> " << cut << " (" << seconds << " s)" << endl;
+                                 }
+                             });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    close(fd);
+    return 0;
 }
-int main()
+
+// ./2105109 [--seed S] [--threads T] [--time S]
+// ./2105109 Convert set1/g1.rud set1/g1.csr
+// ./2105109 Sweep sweep.txt sweep.csv
+int main(int argc, char *argv[])
 {
+    if (argc == 4 && string(argv[1]) == "Sweep")
+    {
+        return runSweep(argv[2], argv[3]);
+    }
+    if (argc == 4 && string(argv[1]) == "Convert")
+    {
+        Graph graph = readGraph(argv[2]);
+        if (!writeBinaryGraph(graph, argv[3]))
+        {
+            cerr << "Error: Could not write " << argv[3] << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    unsigned seed = 1;
+    // Time budget per graph of the path relinking GRASP; 0 skips it.
+    double graspSeconds = 0;
+    int threads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string option = argv[i];
+        if (option == "--seed")
+            seed = stoul(argv[i + 1]);
+        else if (option == "--threads")
+            threads = max(1, stoi(argv[i + 1]));
+        else if (option == "--time")
+            graspSeconds = stod(argv[i + 1]);
+    }
+
     vector<string> graphFiles;
     int noOfGraphs = 54;
     for (int i = 1; i <= noOfGraphs; i++)
     {
-        graphFiles.push_back("set1/g" + to_string(i) + ".rud");
+        // A converted binary copy is preferred when there is one.
+        string binaryFile = "set1/g" + to_string(i) + ".csr";
+        graphFiles.push_back(filesystem::exists(binaryFile) ? binaryFile : "set1/g" + to_string(i) + ".rud");
     }
 
     int randomizedRuns = 30;
@@ -386,57 +907,82 @@ int main()
     csv << "Name,|V|,|E|,Randomized-1,Greedy-1,Semi-greedy-1 (α=" << alpha
         << "),Local-1 Iter,Local-1 Avg,GRASP-1 Iter,GRASP-1 Best,Known Best\n";
 
-    unordered_map<string, int> knownBest = {
-        {"G1", 12078}, {"G22", 14123}, {"G43", 7027}, {"G2", 12084}, {"G3", 12077}, {"G14", 3187}, {"G15", 3169}, {"G16", 3172}, {"G11", 627}, {"G12", 621}, {"G13", 645}, {"G23", 14129}, {"G24", 14131}, {"G32", 1560}, {"G33", 1537}, {"G34", 1541}, {"G35", 8000}, {"G36", 7996}, {"G37", 8009}, {"G44", 7022}, {"G45", 7020}, {"G48", 6000}, {"G49", 6000}, {"G50", 5988}};
-
-    for (const auto &filename : graphFiles)
+    for (size_t graphIndex = 0; graphIndex < graphFiles.size(); graphIndex++)
     {
+        const string &filename = graphFiles[graphIndex];
         Graph g = readGraph(filename);
+        // Every graph gets its own generators, so one graph's numbers do not
+        // depend on which graphs ran before it.
+        seed_seq graphSeed{seed, (unsigned)graphIndex};
+        mt19937 rng(graphSeed);
+        mt19937_64 bitRng(graphSeed);
         int n = g.getNumVertices(), m = g.getNumEdges();
-        string graphName = filename.substr(filename.find_last_of('/') + 1);
-        graphName = graphName.substr(0, graphName.find('.'));
-        graphName[0] = toupper(graphName[0]);
+        string graphName = graphNameOf(filename);
 
         cout << "Processing " << graphName << "..." << endl;
 
         // Randomized
-        double randomizedAvg = RandomizedMaxCut(g, randomizedRuns);
+        double randomizedAvg = RandomizedMaxCut(g, randomizedRuns, bitRng);
 
         // Greedy
         auto [gx, gy] = GreedyMaxCut(g);
         int greedyCut = calculateCutWeight(g, gx, gy);
 
         // Semi-Greedy
-        auto [semiGreedyCut,partitionSet] = semiGreedyMaxCut(g, alpha);
+        auto [semiGreedyCut,partitionSet] = semiGreedyMaxCut(g, alpha, rng);
 
         // Local Search average
         int localCutSum = 0;
+        long long bestCutSum = 0, firstCutSum = 0;
+        LocalSearchStats sweepStats, bestStats, firstStats;
         for (int i = 0; i < localIterations; i++)
         {
-            vector<int> tempPartition(n, -1);
-            auto [su, sv] = g.getMaxmiumEdge();
-            tempPartition[su] = 0;
-            tempPartition[sv] = 1;
-
-            set<int> unassignedVertex;
-            for (int j = 0; j < n; j++)
-                if (tempPartition[j] == -1)
-                    unassignedVertex.insert(j);
-            for (int v : unassignedVertex)
-                tempPartition[v] = rand() % 2;
+            vector<int> tempPartition = randomPartition(g, rng);
 
-            auto [cut, _] = LocalSearch(g, tempPartition);
+            vector<int> bestPartition = tempPartition, firstPartition = tempPartition;
+            auto [cut, _] = LocalSearch(g, tempPartition, &sweepStats);
             localCutSum += cut;
+            bestCutSum += GainLocalSearch(g, bestPartition, ImprovementPolicy::BEST, &bestStats).first;
+            firstCutSum += GainLocalSearch(g, firstPartition, ImprovementPolicy::FIRST, &firstStats).first;
         }
         int localCutAvg = localCutSum / localIterations;
+        cout << "Local search (sweep): avg cut " << localCutAvg << ", " << sweepStats.iterationCount / localIterations
+             << " passes, " << (long long)sweepStats.flipsPerSecond() << " flips/sec" << endl;
+        cout << "Local search (gain buckets, best): avg cut " << bestCutSum / localIterations << ", "
+             << bestStats.iterationCount / localIterations << " flips, " << (long long)bestStats.flipsPerSecond() << " flips/sec" << endl;
+        cout << "Local search (gain buckets, first): avg cut " << firstCutSum / localIterations << ", "
+             << firstStats.iterationCount / localIterations << " flips, " << (long long)firstStats.flipsPerSecond() << " flips/sec" << endl;
 
         // GRASP
-        auto [graspCut, graspLocalAvg] = graspMaxCut(g, alpha, graspIterations);
+        auto [graspCut, graspLocalAvg] = graspMaxCut(g, alpha, graspIterations, rng(), threads);
+        if (graspSeconds > 0)
+        {
+            vector<pair<double, int>> improvements;
+            graspTimed(g, alpha, graspSeconds, rng(), improvements);
+            cout << "GRASP with path relinking (" << graspSeconds << " s), new best cuts:";
+            for (auto [seconds, cut] : improvements)
+            {
+                cout << " " << cut << "@" << seconds << "s";
+            }
+            cout << endl;
+
+            // Tabu search and ILS from one random partition, in the same budget.
+            SearchBudget budget;
+            budget.seconds = graspSeconds;
+            vector<int> tabuPartition = randomPartition(g, rng), ilsPartition = tabuPartition;
+            LocalSearchStats tabuStats, ilsStats;
+            int tabuCut = TabuSearch(g, tabuPartition, rng, budget, &tabuStats).first;
+            int ilsCut = IteratedLocalSearch(g, ilsPartition, rng, ILS_STRENGTH, budget, &ilsStats).first;
+            cout << "Tabu search (" << graspSeconds << " s): best cut " << tabuCut << "@" << tabuStats.bestSeconds << "s, "
+                 << (long long)tabuStats.flipsPerSecond() << " flips/sec" << endl;
+            cout << "Iterated local search (" << graspSeconds << " s): best cut " << ilsCut << "@" << ilsStats.bestSeconds << "s, "
+                 << (long long)ilsStats.flipsPerSecond() << " flips/sec" << endl;
+        }
 
         string knownBestStr = "-";
-        if (knownBest.count(graphName))
+        if (knownBestCut(graphName) != -1)
         {
-            knownBestStr = to_string(knownBest[graphName]);
+            knownBestStr = to_string(knownBestCut(graphName));
         }
 
         csv << graphName << "," << n << "," << m << ","
@@ -0,0 +1,169 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+class Edge
+{
+public:
+    int u, v, w;
+    Edge(int u, int v, int w)
+    {
+        this->u = u;
+        this->v = v;
+        this->w = w;
+    }
+};
+
+// Compressed sparse row storage: the neighbours of v are
+// neighbours[offsets[v] .. offsets[v + 1]), sorted by id, with their edge
+// weights at the same positions of weights. Every edge is stored once in each
+// direction, and nothing else is kept. The three arrays are consecutive in one
+// block of n + 1 + 4m ints, which is also the layout of the binary graph file,
+// so a mapped file is used in place.
+class Graph
+{
+private:
+    int numVertices;
+    int numEdges;
+    // Owns the block: a vector for graphs built in memory or a mapping of a
+    // binary file. Shared, so copies of a Graph point into the same block.
+    shared_ptr<const void> storage;
+    const int *offsets;
+    const int *neighbours;
+    const int *weights;
+    // Heaviest edge, first in input order among equal weights.
+    pair<int, int> maxEdge = {-1, -1};
+
+    void setBlock(const int *block)
+    {
+        offsets = block;
+        neighbours = offsets + numVertices + 1;
+        weights = neighbours + 2 * (size_t)numEdges;
+    }
+
+public:
+    // Vertices in edges are numbered from 1, as in the .rud files.
+    Graph(int n, const vector<Edge> &edges)
+    {
+        numVertices = n;
+        numEdges = edges.size();
+        auto block = make_shared<vector<int>>(n + 1 + 4 * (size_t)numEdges, 0);
+        int *offsets = block->data();
+        int *neighbours = offsets + n + 1;
+        int *weights = neighbours + 2 * (size_t)numEdges;
+        for (const auto &edge : edges)
+        {
+            offsets[edge.u]++;
+            offsets[edge.v]++;
+        }
+        for (int v = 0; v < n; v++)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+        vector<int> next(offsets, offsets + n);
+        int maxWeight = -1;
+        for (const auto &edge : edges)
+        {
+            int u = edge.u - 1, v = edge.v - 1;
+            neighbours[next[u]] = v;
+            weights[next[u]++] = edge.w;
+            neighbours[next[v]] = u;
+            weights[next[v]++] = edge.w;
+            if (edge.w > maxWeight)
+            {
+                maxWeight = edge.w;
+                maxEdge = {u, v};
+            }
+        }
+
+        vector<pair<int, int>> row;
+        for (int v = 0; v < n; v++)
+        {
+            row.clear();
+            for (int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                row.push_back({neighbours[i], weights[i]});
+            }
+            sort(row.begin(), row.end());
+            for (int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                neighbours[i] = row[i - offsets[v]].first;
+                weights[i] = row[i - offsets[v]].second;
+            }
+        }
+        setBlock(offsets);
+        storage = block;
+    }
+    // A graph over a block laid out as above, kept alive by storage.
+    Graph(int n, int m, pair<int, int> maxEdge, shared_ptr<const void> storage, const int *block)
+        : numVertices(n), numEdges(m), storage(storage), maxEdge(maxEdge)
+    {
+        setBlock(block);
+    }
+
+    int getNumVertices()
+    {
+        return numVertices;
+    }
+    int getNumEdges()
+    {
+        return numEdges;
+    }
+    const int *getOffsets()
+    {
+        return offsets;
+    }
+    const int *getNeighbours()
+    {
+        return neighbours;
+    }
+    const int *getWeights()
+    {
+        return weights;
+    }
+    // The whole block: offsets, neighbours and weights, n + 1 + 4m ints.
+    size_t getBlockSize()
+    {
+        return numVertices + 1 + 4 * (size_t)numEdges;
+    }
+
+    // Binary search in the sorted neighbours of u; 0 if there is no edge.
+    int getWeight(int u, int v)
+    {
+        const int *first = neighbours + offsets[u];
+        const int *last = neighbours + offsets[u + 1];
+        const int *it = lower_bound(first, last, v);
+        if (it != last && *it == v)
+        {
+            return weights[it - neighbours];
+        }
+        return 0;
+    }
+    pair<int, int> getMaxmiumEdge()
+    {
+        return maxEdge;
+    }
+    pair<int, int> findMaxWeightEdge()
+    {
+        return maxEdge;
+    }
+};
+
+// Every edge is seen from both ends; it is counted from its lower end only.
+int calculateCutWeight(Graph &graph, const vector<int> &partitionSet)
+{
+    const int *offsets = graph.getOffsets();
+    const int *neighbours = graph.getNeighbours();
+    const int *weights = graph.getWeights();
+    int cutWeight = 0;
+    for (int u = 0; u < graph.getNumVertices(); u++)
+    {
+        for (int i = offsets[u]; i < offsets[u + 1]; i++)
+        {
+            int v = neighbours[i];
+            if (u < v && partitionSet[u] != partitionSet[v])
+                cutWeight += weights[i];
+        }
+    }
+    return cutWeight;
+}
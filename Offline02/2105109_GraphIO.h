@@ -0,0 +1,148 @@
+#pragma once
+#include "2105109_Graph.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+// Binary graph file: this header followed by the CSR block of Graph (offsets,
+// neighbours, weights as 32-bit ints). It is mapped read-only and shared, so
+// every process that loads the same file uses one page-cached copy.
+struct GraphFileHeader
+{
+    char magic[4];
+    int32_t numVertices;
+    int32_t numEdges;
+    int32_t maxEdgeU;
+    int32_t maxEdgeV;
+};
+const char GRAPH_FILE_MAGIC[4] = {'C', 'S', 'R', '1'};
+
+bool writeBinaryGraph(Graph &graph, const string &filename)
+{
+    FILE *file = fopen(filename.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    GraphFileHeader header;
+    memcpy(header.magic, GRAPH_FILE_MAGIC, 4);
+    header.numVertices = graph.getNumVertices();
+    header.numEdges = graph.getNumEdges();
+    header.maxEdgeU = graph.getMaxmiumEdge().first;
+    header.maxEdgeV = graph.getMaxmiumEdge().second;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(graph.getOffsets(), sizeof(int), graph.getBlockSize(), file) == graph.getBlockSize();
+    return fclose(file) == 0 && written;
+}
+
+// Integers of a text file read with one bulk read; anything that is not a
+// digit or a minus sign separates them.
+class IntegerScanner
+{
+private:
+    string text;
+    size_t position = 0;
+
+public:
+    IntegerScanner(FILE *file)
+    {
+        fseek(file, 0, SEEK_END);
+        text.resize(ftell(file));
+        fseek(file, 0, SEEK_SET);
+        text.resize(fread(&text[0], 1, text.size(), file));
+    }
+
+    bool next(int &value)
+    {
+        while (position < text.size() && !isdigit((unsigned char)text[position]) && text[position] != '-')
+            position++;
+        if (position == text.size())
+            return false;
+        bool negative = text[position] == '-';
+        if (negative)
+            position++;
+        value = 0;
+        while (position < text.size() && isdigit((unsigned char)text[position]))
+            value = value * 10 + (text[position++] - '0');
+        if (negative)
+            value = -value;
+        return true;
+    }
+};
+
+Graph readTextGraph(FILE *file, const string &filename)
+{
+    IntegerScanner scanner(file);
+    int n, m;
+    if (!scanner.next(n) || !scanner.next(m))
+    {
+        cerr << "Error: Malformed graph file " << filename << endl;
+        exit(1);
+    }
+    vector<Edge> edges;
+    edges.reserve(m);
+
+    for (int i = 0; i < m; i++)
+    {
+        int u, v, w;
+        if (!scanner.next(u) || !scanner.next(v) || !scanner.next(w) || u < 1 || u > n || v < 1 || v > n)
+        {
+            cerr << "Error: Malformed edge " << i + 1 << " in " << filename << endl;
+            exit(1);
+        }
+        edges.push_back(Edge(u, v, w));
+    }
+    return Graph(n, edges);
+}
+
+Graph mapBinaryGraph(int fd, const string &filename)
+{
+    struct stat status;
+    fstat(fd, &status);
+    size_t length = status.st_size;
+    GraphFileHeader header;
+    if (length < sizeof(header) || pread(fd, &header, sizeof(header), 0) != sizeof(header))
+    {
+        cerr << "Error: Truncated graph file " << filename << endl;
+        exit(1);
+    }
+    size_t blockSize = header.numVertices + 1 + 4 * (size_t)header.numEdges;
+    if (header.numVertices < 0 || header.numEdges < 0 || length != sizeof(header) + blockSize * sizeof(int))
+    {
+        cerr << "Error: Truncated graph file " << filename << endl;
+        exit(1);
+    }
+    void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "Error: Could not map " << filename << endl;
+        exit(1);
+    }
+    shared_ptr<const void> storage(mapping, [length](const void *address)
+                                   { munmap(const_cast<void *>(address), length); });
+    const int *block = (const int *)((const char *)mapping + sizeof(header));
+    return Graph(header.numVertices, header.numEdges, {header.maxEdgeU, header.maxEdgeV}, storage, block);
+}
+
+// Binary files are recognised by their magic and mapped; anything else is
+// parsed as a .rud text file.
+Graph readGraph(const string &filename)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        cerr << "Error: Could not open file " << filename << endl;
+        exit(1);
+    }
+
+    char magic[4] = {};
+    bool binary = fread(magic, 1, 4, file) == 4 && memcmp(magic, GRAPH_FILE_MAGIC, 4) == 0;
+    rewind(file);
+    Graph graph = binary ? mapBinaryGraph(fileno(file), filename) : readTextGraph(file, filename);
+    fclose(file);
+    cout << "Graph read successfully: " << filename << endl;
+    cout << "Number of vertices: " << graph.getNumVertices() << ", Number of edges: " << graph.getNumEdges() << endl;
+    return graph;
+}
@@ -0,0 +1,373 @@
+#pragma once
+#include "2105109_Graph.h"
+using namespace std;
+
+class LocalSearchStats
+{
+public:
+    int iterationCount = 0;
+    long long flips = 0;
+    double seconds = 0;
+    // For the metaheuristics: seconds into the last run when its best cut was found.
+    double bestSeconds = 0;
+
+    double flipsPerSecond() const
+    {
+        return flips / max(seconds, 1e-9);
+    }
+    void add(const LocalSearchStats &other)
+    {
+        iterationCount += other.iterationCount;
+        flips += other.flips;
+        seconds += other.seconds;
+    }
+};
+
+// gain[v] is how much the cut grows if v switches sides: the weight to
+// neighbours on its own side minus the weight to the other side. Flipping v
+// negates gain[v] and moves every neighbour's gain by twice the edge weight,
+// so a flip costs O(deg(v)) and no gain is ever recomputed from scratch.
+class GainTable
+{
+private:
+    Graph &graph;
+    const int *offsets;
+    const int *neighbours;
+    const int *weights;
+
+public:
+    vector<int> gain;
+    vector<int> &partitionSet;
+    int cutWeight;
+    // Upper bound on |gain[v]|: the largest total |weight| at one vertex.
+    int maxGain = 0;
+
+    GainTable(Graph &graph, vector<int> &partitionSet) : graph(graph), partitionSet(partitionSet)
+    {
+        offsets = graph.getOffsets();
+        neighbours = graph.getNeighbours();
+        weights = graph.getWeights();
+        int n = graph.getNumVertices();
+        gain.assign(n, 0);
+        for (int v = 0; v < n; v++)
+        {
+            int total = 0;
+            for (int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                gain[v] += partitionSet[v] == partitionSet[neighbours[i]] ? weights[i] : -weights[i];
+                total += abs(weights[i]);
+            }
+            maxGain = max(maxGain, total);
+        }
+        cutWeight = calculateCutWeight(graph, partitionSet);
+    }
+
+    // Calls changed(u, oldGain) for every neighbour whose gain moved.
+    template <class Changed>
+    void flip(int v, Changed changed)
+    {
+        cutWeight += gain[v];
+        gain[v] = -gain[v];
+        partitionSet[v] ^= 1;
+        for (int i = offsets[v]; i < offsets[v + 1]; i++)
+        {
+            int u = neighbours[i];
+            int oldGain = gain[u];
+            gain[u] += partitionSet[u] == partitionSet[v] ? 2 * weights[i] : -2 * weights[i];
+            changed(u, oldGain);
+        }
+    }
+};
+
+// Vertices bucketed by gain in intrusive doubly linked lists
+// (Fiduccia-Mattheyses); bucket gain + maxGain holds the vertices of that gain.
+// top never lies below the highest non-empty bucket, so taking the best vertex
+// is amortised O(1).
+class GainBuckets
+{
+private:
+    int maxGain;
+    vector<int> head;
+    vector<int> next;
+    vector<int> prev;
+    int top = -1;
+
+public:
+    GainBuckets(int n, int maxGain) : maxGain(maxGain), head(2 * maxGain + 1, -1), next(n, -1), prev(n, -1) {}
+
+    void insert(int v, int gain)
+    {
+        int bucket = gain + maxGain;
+        next[v] = head[bucket];
+        prev[v] = -1;
+        if (head[bucket] != -1)
+            prev[head[bucket]] = v;
+        head[bucket] = v;
+        top = max(top, bucket);
+    }
+    void remove(int v, int gain)
+    {
+        if (prev[v] != -1)
+            next[prev[v]] = next[v];
+        else
+            head[gain + maxGain] = next[v];
+        if (next[v] != -1)
+            prev[next[v]] = prev[v];
+    }
+    // A vertex of the highest gain, or -1 if there are no vertices.
+    int best()
+    {
+        while (top >= 0 && head[top] == -1)
+            top--;
+        return top >= 0 ? head[top] : -1;
+    }
+    // The highest-gain vertex that accept(v) allows, or -1.
+    template <class Accept>
+    int best(Accept accept)
+    {
+        for (int bucket = best() == -1 ? -1 : top; bucket >= 0; bucket--)
+        {
+            for (int v = head[bucket]; v != -1; v = next[v])
+            {
+                if (accept(v))
+                    return v;
+            }
+        }
+        return -1;
+    }
+};
+
+// A GainTable with every vertex in GainBuckets, kept in step on every flip.
+class BucketedGains
+{
+public:
+    GainTable table;
+    GainBuckets buckets;
+
+    BucketedGains(Graph &graph, vector<int> &partitionSet)
+        : table(graph, partitionSet), buckets(graph.getNumVertices(), table.maxGain)
+    {
+        for (int v = 0; v < graph.getNumVertices(); v++)
+        {
+            buckets.insert(v, table.gain[v]);
+        }
+    }
+
+    void flip(int v)
+    {
+        buckets.remove(v, table.gain[v]);
+        table.flip(v, [&](int u, int oldGain)
+                   {
+                       buckets.remove(u, oldGain);
+                       buckets.insert(u, table.gain[u]);
+                   });
+        buckets.insert(v, table.gain[v]);
+    }
+    // Best-improvement hill climbing; flipped vertices are appended to log.
+    int climb(vector<int> *log = nullptr)
+    {
+        int flips = 0;
+        for (int v = buckets.best(); v != -1 && table.gain[v] > 0; v = buckets.best())
+        {
+            flip(v);
+            if (log != nullptr)
+                log->push_back(v);
+            flips++;
+        }
+        return flips;
+    }
+};
+
+enum class ImprovementPolicy
+{
+    BEST,
+    FIRST
+};
+
+// 1-flip hill climbing to the same kind of local optimum as LocalSearch.
+// BEST always flips a vertex of the highest gain; FIRST flips improving
+// vertices in the order their gains turned positive. Returns the cut weight
+// and the number of flips.
+pair<int, int> GainLocalSearch(Graph &graph, vector<int> &partitionSet, ImprovementPolicy policy, LocalSearchStats *stats = nullptr)
+{
+    auto start = chrono::steady_clock::now();
+    int n = graph.getNumVertices();
+    int cutWeight, flips = 0;
+
+    if (policy == ImprovementPolicy::BEST)
+    {
+        BucketedGains gains(graph, partitionSet);
+        flips = gains.climb();
+        cutWeight = gains.table.cutWeight;
+    }
+    else
+    {
+        GainTable table(graph, partitionSet);
+        deque<int> candidates;
+        vector<bool> queued(n, false);
+        for (int v = 0; v < n; v++)
+        {
+            if (table.gain[v] > 0)
+            {
+                candidates.push_back(v);
+                queued[v] = true;
+            }
+        }
+        while (!candidates.empty())
+        {
+            int v = candidates.front();
+            candidates.pop_front();
+            queued[v] = false;
+            if (table.gain[v] <= 0)
+                continue;
+            table.flip(v, [&](int u, int)
+                       {
+                           if (table.gain[u] > 0 && !queued[u])
+                           {
+                               candidates.push_back(u);
+                               queued[u] = true;
+                           }
+                       });
+            flips++;
+        }
+        cutWeight = table.cutWeight;
+    }
+
+    if (stats != nullptr)
+    {
+        stats->iterationCount += flips;
+        stats->flips += flips;
+        stats->seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    return {cutWeight, flips};
+}
+
+// Stopping rule of the metaheuristics below: whichever comes first of the
+// time budget and maxStall moves (tabu) or perturbations (ILS) in a row
+// without a new best. Without a time budget a run is fully reproducible.
+class SearchBudget
+{
+public:
+    double seconds = numeric_limits<double>::infinity();
+    long long maxStall = LLONG_MAX;
+};
+
+// Tabu search: every move flips the best non-tabu vertex, even when that
+// makes the cut smaller, and keeps the vertex from flipping back for a random
+// tenure. A tabu vertex may still move if that gives a new best cut. On
+// return partitionSet is the best partition seen. Returns the best cut and the
+// number of moves.
+pair<int, int> TabuSearch(Graph &graph, vector<int> &partitionSet, mt19937 &rng, SearchBudget budget, LocalSearchStats *stats = nullptr)
+{
+    auto start = chrono::steady_clock::now();
+    int n = graph.getNumVertices();
+    BucketedGains gains(graph, partitionSet);
+    GainTable &table = gains.table;
+    vector<long long> tabuUntil(n, 0);
+    int baseTenure = max(1, n / 100), tenureRange = max(1, n / 10);
+    int bestCut = table.cutWeight;
+    double bestSeconds = 0;
+    // Flips since the best partition, undone before returning.
+    vector<int> sinceBest;
+    long long move = 0, stall = 0;
+
+    while (stall < budget.maxStall)
+    {
+        // The clock is only read every 256 moves.
+        if ((move & 255) == 0 && chrono::duration<double>(chrono::steady_clock::now() - start).count() >= budget.seconds)
+            break;
+        int v = gains.buckets.best([&](int u)
+                                   { return tabuUntil[u] <= move || table.cutWeight + table.gain[u] > bestCut; });
+        if (v == -1)
+            break;
+        gains.flip(v);
+        tabuUntil[v] = move + baseTenure + rng() % tenureRange;
+        move++;
+        if (table.cutWeight > bestCut)
+        {
+            bestCut = table.cutWeight;
+            bestSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            sinceBest.clear();
+            stall = 0;
+        }
+        else
+        {
+            sinceBest.push_back(v);
+            stall++;
+        }
+    }
+    for (int v : sinceBest)
+    {
+        partitionSet[v] ^= 1;
+    }
+
+    if (stats != nullptr)
+    {
+        stats->iterationCount += move;
+        stats->flips += move;
+        stats->seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        stats->bestSeconds = bestSeconds;
+    }
+    return {bestCut, (int)move};
+}
+
+// Iterated local search: climbs to a local optimum, then repeatedly flips
+// max(1, strength * n) random vertices and climbs again. The new local optimum
+// replaces the current one if its cut is at least as large; otherwise the
+// perturbation and the climb are undone flip by flip. Returns the best cut and
+// the number of perturbations; partitionSet ends as the best partition.
+pair<int, int> IteratedLocalSearch(Graph &graph, vector<int> &partitionSet, mt19937 &rng, double strength, SearchBudget budget,
+                                   LocalSearchStats *stats = nullptr)
+{
+    auto start = chrono::steady_clock::now();
+    int n = graph.getNumVertices();
+    BucketedGains gains(graph, partitionSet);
+    GainTable &table = gains.table;
+    long long flips = gains.climb();
+    int kicks = max(1, (int)(strength * n));
+    int bestCut = table.cutWeight;
+    double bestSeconds = 0;
+    vector<int> log;
+    long long perturbations = 0, stall = 0;
+
+    while (stall < budget.maxStall && chrono::duration<double>(chrono::steady_clock::now() - start).count() < budget.seconds)
+    {
+        int previousCut = table.cutWeight;
+        log.clear();
+        for (int i = 0; i < kicks; i++)
+        {
+            int v = rng() % n;
+            gains.flip(v);
+            log.push_back(v);
+        }
+        flips += kicks + gains.climb(&log);
+        perturbations++;
+        if (table.cutWeight > bestCut)
+        {
+            bestCut = table.cutWeight;
+            bestSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            stall = 0;
+        }
+        else
+        {
+            stall++;
+        }
+        if (table.cutWeight < previousCut)
+        {
+            for (auto it = log.rbegin(); it != log.rend(); ++it)
+            {
+                gains.flip(*it);
+            }
+            flips += log.size();
+        }
+    }
+
+    if (stats != nullptr)
+    {
+        stats->iterationCount += perturbations;
+        stats->flips += flips;
+        stats->seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        stats->bestSeconds = bestSeconds;
+    }
+    return {bestCut, (int)perturbations};
+}
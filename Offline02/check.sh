@@ -1,2 +1,4 @@
-g++ 2105109.cpp -o 2105109
-./2105109
\ No newline at end of file
+g++ -O2 -pthread 2105109.cpp -o 2105109
+for f in set1/*.rud; do ./2105109 Convert "$f" "${f%.rud}.csr"; done
+./2105109 --seed 1 --threads 4 --time 5
+./2105109 Sweep sweep.txt sweep.csv